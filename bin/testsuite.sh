@@ -19,28 +19,181 @@
 # some basic checks
 # ----------------------------------------------------------------------------
 
-./pico-regex.bin ''              ''                                  || exit 1
-./pico-regex.bin '^$'            ''                                  || exit 1
-./pico-regex.bin '^.*$'          'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^lorem.*$'     'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^.*ipsum.*$'   'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^.*dolor.*$'   'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^.*sit.*$'     'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^.*amet$'      'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^lorem.*amet$' 'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin 'lorem'         'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin 'ipsum'         'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin 'dolor'         'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin 'sit'           'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin 'amet'          'lorem ipsum dolor sit amet'        || exit 1
-./pico-regex.bin '^a?zerty$'     'zerty'                             || exit 1
-./pico-regex.bin '^a?zerty$'     'azerty'                            || exit 1
-./pico-regex.bin '^a?azerty$'    'azerty'                            || exit 1
-./pico-regex.bin '^a?azerty$'    'aazerty'                           || exit 1
-./pico-regex.bin '^a+zerty$'     'azerty'                            || exit 1
-./pico-regex.bin '^a+zerty$'     'aazerty'                           || exit 1
-./pico-regex.bin '^a+zerty$'     'aaazerty'                          || exit 1
-./pico-regex.bin '^a+zerty$'     'aaaazerty'                         || exit 1
+for engine in auto backtrack dfa fulldfa
+do
+    ./pico-regex.bin --engine=${engine} ''              ''                                  || exit 1
+    ./pico-regex.bin --engine=${engine} '^$'            ''                                  || exit 1
+    ./pico-regex.bin --engine=${engine} '^.*$'          'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^lorem.*$'     'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^.*ipsum.*$'   'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^.*dolor.*$'   'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^.*sit.*$'     'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^.*amet$'      'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^lorem.*amet$' 'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} 'lorem'         'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} 'ipsum'         'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} 'dolor'         'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} 'sit'           'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} 'amet'          'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} 'sit amet$'     'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} '^ipsum'        'lorem ipsum dolor sit amet'        && exit 1
+    ./pico-regex.bin --engine=${engine} '^a?zerty$'     'zerty'                             || exit 1
+    ./pico-regex.bin --engine=${engine} '^a?zerty$'     'azerty'                            || exit 1
+    ./pico-regex.bin --engine=${engine} '^a?azerty$'    'azerty'                            || exit 1
+    ./pico-regex.bin --engine=${engine} '^a?azerty$'    'aazerty'                           || exit 1
+    ./pico-regex.bin --engine=${engine} '^a+zerty$'     'azerty'                            || exit 1
+    ./pico-regex.bin --engine=${engine} '^a+zerty$'     'aazerty'                           || exit 1
+    ./pico-regex.bin --engine=${engine} '^a+zerty$'     'aaazerty'                          || exit 1
+    ./pico-regex.bin --engine=${engine} '^a+zerty$'     'aaaazerty'                         || exit 1
+    ./pico-regex.bin --engine=${engine} '^lorem$'       'lorem ipsum dolor sit amet'        && exit 1
+    ./pico-regex.bin --engine=${engine} '^a+zerty$'     'zerty'                             && exit 1
+    ./pico-regex.bin --engine=${engine} 'b*$'           'abc'                               || exit 1
+    ./pico-regex.bin --engine=${engine} 'LOREM'         'lorem ipsum dolor sit amet'        && exit 1
+    ./pico-regex.bin --engine=${engine} -i 'LOREM'      'lorem ipsum dolor sit amet'        || exit 1
+    ./pico-regex.bin --engine=${engine} -i '^l+OREM.*T$' 'LLLorem ipsum dolor sit amet'     || exit 1
+    ./pico-regex.bin --engine=${engine} '^a{3}$'        'aaa'                               || exit 1
+    ./pico-regex.bin --engine=${engine} '^a{3}$'        'aaaa'                              && exit 1
+    ./pico-regex.bin --engine=${engine} '^x{1,3}y$'     'xxxy'                              || exit 1
+    ./pico-regex.bin --engine=${engine} '^.{2,}$'       'a'                                 && exit 1
+    ./pico-regex.bin --engine=${engine} 'x.{100}y'      "$(printf 'axx%0100dyy' 0)"         || exit 1
+    ./pico-regex.bin --engine=${engine} 'x.{100}y'      "$(printf 'ax%098dyy' 0)"           && exit 1
+    ./pico-regex.bin --engine=${engine} 'l.rem.*amet'   'lorem'                             && exit 1
+    ./pico-regex.bin --engine=${engine} '^a?b{2}$'      'abbb'                              && exit 1
+    ./pico-regex.bin --engine=${engine} 'a{,2}'         'a{,2}'                             || exit 1
+    ./pico-regex.bin --engine=${engine} '^a*+b$'        'aaab'                              || exit 1
+    ./pico-regex.bin --engine=${engine} '^a*+a$'        'aaa'                               && exit 1
+    ./pico-regex.bin --engine=${engine} '^a.*?b$'       'axbyb'                             || exit 1
+    ./pico-regex.bin --engine=${engine} '^a+?$'         'aaa'                               || exit 1
+    ./pico-regex.bin --engine=${engine} 'GET|POST|PUT'  'PUT /index.html'                   || exit 1
+    ./pico-regex.bin --engine=${engine} 'GET|POST|PUT'  'PATCH /index.html'                 && exit 1
+    ./pico-regex.bin --engine=${engine} '^a+z|^b+z$'    'bbz'                               || exit 1
+    ./pico-regex.bin --engine=${engine} -i 'get|post'   'POST /index.html'                  || exit 1
+    ./pico-regex.bin --engine=${engine} '^.$'           'é'                                 && exit 1
+    ./pico-regex.bin --engine=${engine} -u '^.$'        'é'                                 || exit 1
+    ./pico-regex.bin --engine=${engine} -u '^é+$'       'ééé'                               || exit 1
+    ./pico-regex.bin --engine=${engine} -u '^a.c$'      'a€c'                               || exit 1
+    ./pico-regex.bin --engine=${engine} '^b$'           "$(printf 'a\nb\nc')"               && exit 1
+    ./pico-regex.bin --engine=${engine} -m '^b$'        "$(printf 'a\nb\nc')"               || exit 1
+    test "$(./pico-regex.bin -q --engine=${engine} -m '^b|c$' "$(printf 'a\nbx\nxc')")" = "$(printf '2:bx\n5:xc')" || exit 1
+    test "$(printf 'ab\nb\nba\n' | ./pico-regex.bin -q --engine=${engine} -c '^b')" = "2"                || exit 1
+    ./pico-regex.bin --engine=${engine} --segments=2 '^lorem.*amet$' 'lorem ipsum dolor sit amet'       || exit 1
+    ./pico-regex.bin --engine=${engine} --segments=1 'm d'           'lorem ipsum dolor sit amet'       || exit 1
+    ./pico-regex.bin --engine=${engine} --segments=3 'm d'           'lorem ipsum dolor sit amet'       || exit 1
+    ./pico-regex.bin --engine=${engine} --segments=3 'm  d'          'lorem ipsum dolor sit amet'       && exit 1
+    ./pico-regex.bin --engine=${engine} --segments=2 '^a+zerty$'     'aaazerty'                         || exit 1
+done
+
+# ----------------------------------------------------------------------------
+# compile errors
+# ----------------------------------------------------------------------------
+
+./pico-regex.bin '*lorem'        'lorem'                             && exit 1
+./pico-regex.bin 'lorem\z'       'lorem'                             && exit 1
+./pico-regex.bin 'lorem\'        'lorem'                             && exit 1
+./pico-regex.bin 'lo{3,2}rem'    'lorem'                             && exit 1
+./pico-regex.bin 'lorem' 'lorem' 2>&1 | grep -q 'at offset'          && exit 1
+./pico-regex.bin 'lor**em' 'lorem' 2>&1 | grep -q 'at offset 4'      || exit 1
+
+# ----------------------------------------------------------------------------
+# tracing and statistics
+# ----------------------------------------------------------------------------
+
+./pico-regex.bin --trace '^a*zerty$' 'aaaazerty'                   || exit 1
+./pico-regex.bin --stats '^a*zerty$' 'aaaazerty'                   || exit 1
+./pico-regex.bin --stats --engine=dfa '^a*zerty$' 'aaaazerty'      || exit 1
+./pico-regex.bin --debug 'a.*b.*c' 'xaxbxc' | grep -q 'selecting<dfa>'                                   || exit 1
+./pico-regex.bin --debug '^a?a?a?aaa$' 'aaa' | grep -q 'selecting<dfa>'                                     || exit 1
+./pico-regex.bin --debug -c '^q' "$(printf 'lorem ipsum dolor sit amet\n%.0s' 1 2 3 4 5 6 7 8 9 10)" | grep -q 'selecting<backtrack>' || exit 1
+./pico-regex.bin --debug -c 'a.q' "$(printf 'abacadaeafagahaiajak%.0s' 1 2 3 4 5 6 7 8 9 10 11 12 13)" | grep -q 'selecting<dfa>' || exit 1
+./pico-regex.bin --engine=fulldfa 'x.{100}y' 'xy' | grep -q 'backtracking executor is used instead'            || exit 1
+./pico-regex.bin --engine=backtrack --segments=2 '^a+z' 'aaz' | grep -q 'dfa engine is used instead'        || exit 1
+./pico-regex.bin --segments=4 'x.{100}y' "$(printf 'axx%0100dyy' 0)" 2>&1 | grep -q 'cannot match a chain' || exit 1
+./pico-regex.bin --debug --engine=dfa 'xa{100}y' 'xy' | grep -q 'selecting<dfa>'                              || exit 1
+./pico-regex.bin --debug --engine=dfa '^a{0,2}a{0,2}a{0,2}a{0,2}a{0,2}aab$' 'aab' | grep -q 'selecting<dfa>'  || exit 1
+if ! ./pico-regex.bin --stats 'a' 'a' | grep -q 'not available'
+then
+    ./pico-regex.bin --stats --engine=backtrack -c 'ab?q' "$(printf 'abq\nzz')" | grep -q 'start_offsets <1>' || exit 1
+fi
+
+# ----------------------------------------------------------------------------
+# saved full DFA
+# ----------------------------------------------------------------------------
+
+dfa_file="${TMPDIR:-/tmp}/pico-regex.$$.dfa"
+./pico-regex.bin --engine=fulldfa --dfa-file="${dfa_file}" 'a+b|cd' 'xxaab'           || exit 1
+./pico-regex.bin --engine=fulldfa --dfa-file="${dfa_file}" 'a+b|cd' 'xxacb'           && exit 1
+./pico-regex.bin --engine=fulldfa --dfa-file="${dfa_file}" 'a+b|ce' 'xxace'           || exit 1
+printf 'lorem ipsum\n' > "${dfa_file}"
+./pico-regex.bin --engine=fulldfa --dfa-file="${dfa_file}" 'a+b|cd' 'xxaab'           && exit 1
+test "$(cat "${dfa_file}")" = "lorem ipsum"                                           || exit 1
+rm -f "${dfa_file}"
+
+# ----------------------------------------------------------------------------
+# read pipeline
+# ----------------------------------------------------------------------------
+
+read_file="${TMPDIR:-/tmp}/pico-regex.$$.txt"
+printf 'ab\nb\nba\nb' > "${read_file}"
+for io in mmap uring thread
+do
+    test "$(./pico-regex.bin -q -c --io=${io} '^b' < "${read_file}")" = "3"         || exit 1
+    test "$(cat "${read_file}" | ./pico-regex.bin -q -c --io=${io} 'a$')" = "1"     || exit 1
+done
+rm -f "${read_file}"
+./pico-regex.bin -q -c --io=floppy 'a' < /dev/null                                   && exit 1
+
+# ----------------------------------------------------------------------------
+# compressed inputs
+# ----------------------------------------------------------------------------
+
+gzip_file="${TMPDIR:-/tmp}/pico-regex.$$.gz"
+if command -v gzip > /dev/null
+then
+    printf 'lorem\nipsum\n' | gzip >  "${gzip_file}"
+    printf 'dolor\nlorem\n' | gzip >> "${gzip_file}"
+    if ! ./pico-regex.bin -q -c 'lorem' < "${gzip_file}" 2>&1 | grep -q 'not compiled in'
+    then
+        test "$(./pico-regex.bin -q -c '^lorem$' < "${gzip_file}")" = "2"               || exit 1
+        test "$(./pico-regex.bin -q -c --io=uring 'o' < "${gzip_file}")" = "3"          || exit 1
+        test "$(./pico-regex.bin -q -r 'dolor' "${gzip_file}")" = "${gzip_file}:12:dolor" || exit 1
+        head -c 20 "${gzip_file}" > "${gzip_file}.cut"
+        ./pico-regex.bin -q -c 'lorem' < "${gzip_file}.cut"                          && exit 1
+    fi
+fi
+rm -f "${gzip_file}" "${gzip_file}.cut"
+
+# ----------------------------------------------------------------------------
+# recursive mode
+# ----------------------------------------------------------------------------
+
+tree_dir="${TMPDIR:-/tmp}/pico-regex.$$.tree"
+mkdir -p "${tree_dir}/a/b" "${tree_dir}/c"
+printf 'lorem\nipsum\n' > "${tree_dir}/a/b/one.txt"
+printf 'dolor\nlorem\n' > "${tree_dir}/c/two.txt"
+printf 'amet\n'          > "${tree_dir}/three.txt"
+for threads in 1 4
+do
+    test "$(./pico-regex.bin -q -r --threads=${threads} '^lorem$' "${tree_dir}" | sort)" = "$(printf '%s\n' "${tree_dir}/a/b/one.txt:0:lorem" "${tree_dir}/c/two.txt:6:lorem")" || exit 1
+    test "$(./pico-regex.bin -q -r -c --threads=${threads} 'o' "${tree_dir}" | sort)" = "$(printf '%s\n' "${tree_dir}/a/b/one.txt:1" "${tree_dir}/c/two.txt:2")"           || exit 1
+done
+./pico-regex.bin -q -r 'sit' "${tree_dir}"                                            && exit 1
+rm -rf "${tree_dir}"
+
+# ----------------------------------------------------------------------------
+# batch mode
+# ----------------------------------------------------------------------------
+
+test "$(printf 'lorem\tlorem ipsum\n^ipsum\tlorem ipsum\n' | ./pico-regex.bin --batch)" = "$(printf '1\n0')" || exit 1
+test "$(printf 'lorem\nipsum\nlorem\n' | ./pico-regex.bin --batch '^l')" = "$(printf '1\n0\n1')"             || exit 1
+test "$(printf '5:lorem\n11:lorem\tipsum\n' | ./pico-regex.bin --batch=length)" = "1"                         || exit 1
+printf '99999999999999999999999:x' | ./pico-regex.bin --batch=length 2>&1 | grep -q 'invalid length prefix'      || exit 1
+
+batch_file="${TMPDIR:-/tmp}/pico-regex.$$.batch"
+(printf 'a\tab\n'; sleep 2) | ./pico-regex.bin --batch > "${batch_file}" &
+sleep 1
+test "$(cat "${batch_file}")" = "1"                                                                         || exit 1
+wait
+rm -f "${batch_file}"
 
 # ----------------------------------------------------------------------------
 # End-Of-File
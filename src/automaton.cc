@@ -0,0 +1,626 @@
+/*
+ * automaton.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <iostream>
+#include <stdexcept>
+#include "automaton.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::NONE
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr uint32_t NONE = ~static_cast<uint32_t>(0);
+
+}
+
+// ---------------------------------------------------------------------------
+// Automaton
+// ---------------------------------------------------------------------------
+
+Automaton::Automaton()
+    : _nodes()
+    , _sets()
+    , _start(NONE)
+    , _min_length(0)
+    , _max_length(ByteCode::UNBOUNDED)
+    , _multiline(false)
+    , _anchored(false)
+    , _valid(false)
+{
+}
+
+auto Automaton::clear() -> void
+{
+    _nodes.clear();
+    _sets.clear();
+    _start      = NONE;
+    _min_length = 0;
+    _max_length = ByteCode::UNBOUNDED;
+    _multiline  = false;
+    _anchored   = false;
+    _valid      = false;
+}
+
+auto Automaton::add_node(const uint8_t type, const uint32_t set) -> uint32_t
+{
+    const uint32_t index = static_cast<uint32_t>(_nodes.size());
+
+    _nodes.push_back(Node { type, NONE, NONE, set });
+
+    return index;
+}
+
+auto Automaton::add_set(const ByteSet& set) -> uint32_t
+{
+    const uint32_t index = static_cast<uint32_t>(_sets.size());
+
+    _sets.push_back(set);
+
+    return index;
+}
+
+auto Automaton::build(const ByteCode& bytecode) -> bool
+{
+    ByteCodeIterator      iterator(bytecode);
+    std::vector<uint32_t> holes;
+    std::vector<uint32_t> pending;
+    uint32_t              utf8_sets = NONE;
+    bool                  floating  = (bytecode.anchored_begin() == false);
+    bool                  known     = true;
+    ByteSet               entry;
+
+    /* the bytes that may have been consumed right before the current node, when known */
+    entry.fill();
+
+    /* holes waiting for a forward jump target, ordered by bytecode offset */
+    using Jump = std::pair<uint32_t, uint32_t>;
+    std::priority_queue<Jump, std::vector<Jump>, std::greater<Jump>> waiting;
+
+    auto hole_out = [](const uint32_t node) -> uint32_t
+    {
+        return (node << 1) | 0;
+    };
+
+    auto hole_alt = [](const uint32_t node) -> uint32_t
+    {
+        return (node << 1) | 1;
+    };
+
+    auto patch = [&](const uint32_t hole, const uint32_t entry) -> void
+    {
+        Node& node(_nodes[hole >> 1]);
+        if((hole & 1) == 0) {
+            node.out = entry;
+        }
+        else {
+            node.alt = entry;
+        }
+    };
+
+    auto connect = [&](const uint32_t entry) -> void
+    {
+        if(_start == NONE) {
+            _start = entry;
+        }
+        for(const uint32_t hole : holes) {
+            patch(hole, entry);
+        }
+        holes.swap(pending);
+        pending.clear();
+    };
+
+    auto range_set = [&](const uint8_t lower, const uint8_t upper) -> uint32_t
+    {
+        ByteSet set;
+        set.clear();
+        for(uint32_t byte = lower; byte <= upper; ++byte) {
+            set.add(byte);
+        }
+        return add_set(set);
+    };
+
+    /* a unit is one copy of the repeated atom: it returns its entry node and leaves its exits pending */
+
+    auto unit_byte = [&](const uint32_t set) -> uint32_t
+    {
+        const uint32_t byte = add_node(NODE_BYTE, set);
+        pending.push_back(hole_out(byte));
+        return byte;
+    };
+
+    auto unit_chain = [&](const uint32_t* sets, const size_t count) -> uint32_t
+    {
+        const uint32_t entry = add_node(NODE_BYTE, sets[0]);
+        uint32_t       last  = entry;
+        for(size_t index = 1; index < count; ++index) {
+            const uint32_t byte = add_node(NODE_BYTE, sets[index]);
+            _nodes[last].out = byte;
+            last = byte;
+        }
+        pending.push_back(hole_out(last));
+        return entry;
+    };
+
+    auto unit_utf8 = [&]() -> uint32_t
+    {
+        static const uint8_t ranges[9][4][2] = {
+            { { 0x00, 0x7f }, { 0x00, 0x00 }, { 0x00, 0x00 }, { 0x00, 0x00 } },
+            { { 0xc2, 0xdf }, { 0x80, 0xbf }, { 0x00, 0x00 }, { 0x00, 0x00 } },
+            { { 0xe0, 0xe0 }, { 0xa0, 0xbf }, { 0x80, 0xbf }, { 0x00, 0x00 } },
+            { { 0xe1, 0xec }, { 0x80, 0xbf }, { 0x80, 0xbf }, { 0x00, 0x00 } },
+            { { 0xed, 0xed }, { 0x80, 0x9f }, { 0x80, 0xbf }, { 0x00, 0x00 } },
+            { { 0xee, 0xef }, { 0x80, 0xbf }, { 0x80, 0xbf }, { 0x00, 0x00 } },
+            { { 0xf0, 0xf0 }, { 0x90, 0xbf }, { 0x80, 0xbf }, { 0x80, 0xbf } },
+            { { 0xf1, 0xf3 }, { 0x80, 0xbf }, { 0x80, 0xbf }, { 0x80, 0xbf } },
+            { { 0xf4, 0xf4 }, { 0x80, 0x8f }, { 0x80, 0xbf }, { 0x80, 0xbf } },
+        };
+        static const uint8_t lengths[9] = { 1, 2, 3, 3, 3, 3, 4, 4, 4 };
+        uint32_t sets[9][4];
+
+        if(utf8_sets == NONE) {
+            utf8_sets = static_cast<uint32_t>(_sets.size());
+            for(size_t branch = 0; branch < 9; ++branch) {
+                for(size_t index = 0; index < lengths[branch]; ++index) {
+                    static_cast<void>(range_set(ranges[branch][index][0], ranges[branch][index][1]));
+                }
+            }
+        }
+        for(size_t branch = 0, set = utf8_sets; branch < 9; ++branch) {
+            for(size_t index = 0; index < lengths[branch]; ++index) {
+                sets[branch][index] = static_cast<uint32_t>(set++);
+            }
+        }
+        uint32_t entry = unit_chain(sets[8], lengths[8]);
+        for(size_t branch = 8; branch-- != 0;) {
+            const uint32_t split = add_node(NODE_SPLIT, 0);
+            const uint32_t chain = unit_chain(sets[branch], lengths[branch]);
+            _nodes[split].out = chain;
+            _nodes[split].alt = entry;
+            entry = split;
+        }
+        return entry;
+    };
+
+    auto overlaps = [](const ByteSet& set1, const ByteSet& set2) -> bool
+    {
+        return ((set1.bits[0] & set2.bits[0]) | (set1.bits[1] & set2.bits[1])
+              | (set1.bits[2] & set2.bits[2]) | (set1.bits[3] & set2.bits[3])) != 0;
+    };
+
+    auto includes = [](const ByteSet& set1, const ByteSet& set2) -> bool
+    {
+        return ((set2.bits[0] & ~set1.bits[0]) | (set2.bits[1] & ~set1.bits[1])
+              | (set2.bits[2] & ~set1.bits[2]) | (set2.bits[3] & ~set1.bits[3])) == 0;
+    };
+
+    auto build_repeat = [&](const uint32_t min, const uint32_t max, const ByteSet& bytes, const size_t unit_size, const std::function<uint32_t()>& unit) -> bool
+    {
+        const uint64_t copies = (max == ~static_cast<uint32_t>(0) ? static_cast<uint64_t>(min) + 1 : max);
+        const uint64_t bound  = (max == ~static_cast<uint32_t>(0) ? min : max);
+        if((_nodes.size() + copies * (unit_size + 1)) > MAX_NODES) {
+            return false;
+        }
+        /*
+         * when a match may start anew while a counted repetition is running,
+         * and the repeated unit accepts both the byte that enters it and some
+         * others, as in x.{100}y, each copy of the unit is a position that
+         * may be active at once: a DFA state is a subset of them and their
+         * number grows exponentially, the backtracker is used instead
+         */
+        if((bound > MAX_UNROLLED) && (floating != false)) {
+            if((known == false) || (overlaps(bytes, entry) && (includes(entry, bytes) == false))) {
+                return false;
+            }
+        }
+        for(uint32_t index = 0; index < min; ++index) {
+            connect(unit());
+        }
+        if(max == ~static_cast<uint32_t>(0)) {
+            const uint32_t split = add_node(NODE_SPLIT, 0);
+            const size_t   mark  = pending.size();
+            const uint32_t entry = unit();
+            _nodes[split].out = entry;
+            for(size_t hole = mark; hole < pending.size(); ++hole) {
+                patch(pending[hole], split);
+            }
+            pending.resize(mark);
+            pending.push_back(hole_alt(split));
+            connect(split);
+        }
+        else {
+            /* nested optionals: every skip jumps past the whole repetition */
+            std::vector<uint32_t> skips;
+            for(uint32_t index = min; index < max; ++index) {
+                const uint32_t split = add_node(NODE_SPLIT, 0);
+                const uint32_t entry = unit();
+                _nodes[split].out = entry;
+                skips.push_back(hole_alt(split));
+                connect(split);
+            }
+            holes.insert(holes.end(), skips.begin(), skips.end());
+        }
+        if(max == ~static_cast<uint32_t>(0)) {
+            floating = true;
+        }
+        if(min == 0) {
+            for(size_t word = 0; word < 4; ++word) {
+                entry.bits[word] |= bytes.bits[word];
+            }
+        }
+        else {
+            entry = bytes;
+            known = true;
+        }
+        return true;
+    };
+
+    auto build_any = [&](const uint32_t min, const uint32_t max) -> bool
+    {
+        ByteSet set;
+        set.fill();
+        const uint32_t index = add_set(set);
+        return build_repeat(min, max, set, 1, [&]() -> uint32_t { return unit_byte(index); });
+    };
+
+    auto build_chr = [&](const uint32_t min, const uint32_t max) -> bool
+    {
+        ByteSet set;
+        set.clear();
+        set.add(iterator.next_byte());
+        const uint32_t index = add_set(set);
+        return build_repeat(min, max, set, 1, [&]() -> uint32_t { return unit_byte(index); });
+    };
+
+    auto build_ch2 = [&](const uint32_t min, const uint32_t max) -> bool
+    {
+        ByteSet set;
+        set.clear();
+        set.add(iterator.next_byte());
+        set.add(iterator.next_byte());
+        const uint32_t index = add_set(set);
+        return build_repeat(min, max, set, 1, [&]() -> uint32_t { return unit_byte(index); });
+    };
+
+    auto build_seq = [&](const uint32_t min, const uint32_t max) -> bool
+    {
+        const uint8_t         count = iterator.next_byte();
+        std::vector<uint32_t> sets;
+        ByteSet               bytes;
+        bytes.clear();
+        for(uint8_t index = 0; index < count; ++index) {
+            const uint8_t byte = iterator.next_byte();
+            ByteSet set;
+            set.clear();
+            set.add(byte);
+            sets.push_back(add_set(set));
+            bytes.add(byte);
+        }
+        if(count == 0) {
+            return true;
+        }
+        if(build_repeat(min, max, bytes, count, [&]() -> uint32_t { return unit_chain(sets.data(), sets.size()); }) == false) {
+            return false;
+        }
+        if(min != 0) {
+            entry = _sets[sets.back()];
+        }
+        return true;
+    };
+
+    auto build_utf = [&](const uint32_t min, const uint32_t max) -> bool
+    {
+        ByteSet bytes;
+        bytes.fill();
+        return build_repeat(min, max, bytes, 35, unit_utf8);
+    };
+
+    auto first_set = [&](ByteCodeIterator& bytecode, const uint8_t opcode, ByteSet& set) -> bool
+    {
+        set.clear();
+        switch(opcode) {
+            case ByteCode::OP_ANY:
+            case ByteCode::OP_UTF:
+                set.fill();
+                return true;
+            case ByteCode::OP_CHR:
+                set.add(bytecode.next_byte());
+                return true;
+            case ByteCode::OP_CH2:
+                set.add(bytecode.next_byte());
+                set.add(bytecode.next_byte());
+                return true;
+            case ByteCode::OP_SEQ:
+                {
+                    const uint8_t count = bytecode.next_byte();
+                    set.add(bytecode.next_byte());
+                    bytecode.advance(count - 1);
+                }
+                return true;
+            default:
+                break;
+        }
+        return false;
+    };
+
+    auto disjoint = [](const ByteSet& set1, const ByteSet& set2) -> bool
+    {
+        return ((set1.bits[0] & set2.bits[0]) | (set1.bits[1] & set2.bits[1])
+              | (set1.bits[2] & set2.bits[2]) | (set1.bits[3] & set2.bits[3])) == 0;
+    };
+
+    /*
+     * a possessive repeat behaves as a greedy one when nothing that may follow
+     * can start with a byte of the repeated atom: the greedy run can then only
+     * stop at its longest length, which is the one the possessive run keeps
+     */
+    auto possessive = [&](ByteCodeIterator atom) -> bool
+    {
+        ByteSet repeated;
+        ByteSet following;
+        if(first_set(atom, atom.next_byte(), repeated) == false) {
+            return false;
+        }
+        while(atom) {
+            const uint8_t opcode = atom.next_byte();
+            switch(opcode) {
+                case ByteCode::OP_NOP:
+                    continue;
+                case ByteCode::OP_ETX:
+                case ByteCode::OP_RET:
+                    return true;
+                case ByteCode::OP_EOL:
+                    return repeated.has('\n') == false;
+                case ByteCode::OP_JMP:
+                    atom.jump(atom.next_long());
+                    continue;
+                case ByteCode::OP_REP:
+                case ByteCode::OP_POS:
+                case ByteCode::OP_LZY:
+                    {
+                        const uint32_t min = atom.next_long();
+                        static_cast<void>(atom.next_long());
+                        if((first_set(atom, atom.next_byte(), following) == false) || (disjoint(repeated, following) == false)) {
+                            return false;
+                        }
+                        if(min == 0) {
+                            continue;
+                        }
+                    }
+                    return true;
+                default:
+                    if(first_set(atom, opcode, following) == false) {
+                        return false;
+                    }
+                    return disjoint(repeated, following);
+            }
+        }
+        return true;
+    };
+
+    auto build_rep = [&](const bool possessive_repeat) -> bool
+    {
+        const uint32_t min = iterator.next_long();
+        const uint32_t max = iterator.next_long();
+        if((possessive_repeat != false) && (possessive(iterator) == false)) {
+            return false;
+        }
+        switch(iterator.next_byte()) {
+            case ByteCode::OP_ANY:
+                return build_any(min, max);
+            case ByteCode::OP_CHR:
+                return build_chr(min, max);
+            case ByteCode::OP_CH2:
+                return build_ch2(min, max);
+            case ByteCode::OP_SEQ:
+                return build_seq(min, max);
+            case ByteCode::OP_UTF:
+                return build_utf(min, max);
+            default:
+                break;
+        }
+        return false;
+    };
+
+    auto build_alt = [&]() -> bool
+    {
+        const uint32_t target = iterator.next_long();
+        const uint32_t split  = add_node(NODE_SPLIT, 0);
+        pending.push_back(hole_out(split));
+        connect(split);
+        waiting.push(Jump(target, hole_alt(split)));
+        return true;
+    };
+
+    auto build_jmp = [&]() -> bool
+    {
+        const uint32_t target = iterator.next_long();
+        for(const uint32_t hole : holes) {
+            waiting.push(Jump(target, hole));
+        }
+        holes.clear();
+        return true;
+    };
+
+    auto build_jtb = [&]() -> bool
+    {
+        const uint8_t lower = iterator.next_byte();
+        const uint8_t upper = iterator.next_byte();
+        std::vector<uint32_t> targets;
+        std::vector<uint32_t> bytes;
+        for(uint32_t byte = lower; byte <= upper; ++byte) {
+            const uint32_t target = iterator.next_long();
+            if(target != 0) {
+                targets.push_back(target);
+                bytes.push_back(byte);
+            }
+        }
+        /* one byte node per distinct target, reached through a chain of splits */
+        uint32_t entry = NONE;
+        for(size_t index = 0; index < targets.size(); ++index) {
+            if(std::find(targets.begin(), targets.begin() + index, targets[index]) != targets.begin() + index) {
+                continue;
+            }
+            ByteSet set;
+            set.clear();
+            for(size_t other = index; other < targets.size(); ++other) {
+                if(targets[other] == targets[index]) {
+                    set.add(bytes[other]);
+                }
+            }
+            const uint32_t byte = add_node(NODE_BYTE, add_set(set));
+            waiting.push(Jump(targets[index], hole_out(byte)));
+            if(entry == NONE) {
+                entry = byte;
+            }
+            else {
+                const uint32_t split = add_node(NODE_SPLIT, 0);
+                _nodes[split].out = byte;
+                _nodes[split].alt = entry;
+                entry = split;
+            }
+        }
+        if(entry == NONE) {
+            return false;
+        }
+        connect(entry);
+        return true;
+    };
+
+    auto build_assertion = [&](const uint8_t type) -> bool
+    {
+        const uint32_t node = add_node(type, 0);
+        pending.push_back(hole_out(node));
+        connect(node);
+        return true;
+    };
+
+    auto build_line_assertion = [&](const uint8_t type) -> bool
+    {
+        _multiline = true;
+        if(type == NODE_BOL) {
+            /* a match may start again after every newline */
+            floating = true;
+            entry.clear();
+            entry.add('\n');
+        }
+        return build_assertion(type);
+    };
+
+    auto build_match = [&]() -> bool
+    {
+        connect(add_node(NODE_MATCH, 0));
+        return true;
+    };
+
+    auto do_build = [&]() -> bool
+    {
+        while(iterator) {
+            bool status = false;
+            while((waiting.empty() == false) && (waiting.top().first <= iterator.offset())) {
+                holes.push_back(waiting.top().second);
+                waiting.pop();
+                known = false;
+            }
+            switch(iterator.next_byte()) {
+                case ByteCode::OP_NOP:
+                    status = true;
+                    break;
+                case ByteCode::OP_STX:
+                    status = build_assertion(NODE_STX);
+                    break;
+                case ByteCode::OP_ETX:
+                    status = build_assertion(NODE_ETX);
+                    break;
+                case ByteCode::OP_BOL:
+                    status = build_line_assertion(NODE_BOL);
+                    break;
+                case ByteCode::OP_EOL:
+                    status = build_line_assertion(NODE_EOL);
+                    break;
+                case ByteCode::OP_ANY:
+                    status = build_any(1, 1);
+                    break;
+                case ByteCode::OP_CHR:
+                    status = build_chr(1, 1);
+                    break;
+                case ByteCode::OP_CH2:
+                    status = build_ch2(1, 1);
+                    break;
+                case ByteCode::OP_SEQ:
+                    status = build_seq(1, 1);
+                    break;
+                case ByteCode::OP_UTF:
+                    status = build_utf(1, 1);
+                    break;
+                case ByteCode::OP_REP:
+                case ByteCode::OP_LZY:
+                    status = build_rep(false);
+                    break;
+                case ByteCode::OP_POS:
+                    status = build_rep(true);
+                    break;
+                case ByteCode::OP_ALT:
+                    status = build_alt();
+                    break;
+                case ByteCode::OP_JMP:
+                    status = build_jmp();
+                    break;
+                case ByteCode::OP_JTB:
+                    status = build_jtb();
+                    break;
+                case ByteCode::OP_RET:
+                    return build_match();
+                default:
+                    break;
+            }
+            if(status == false) {
+                return false;
+            }
+        }
+        return false;
+    };
+
+    clear();
+    _min_length = bytecode.min_length();
+    _max_length = bytecode.max_length();
+    _anchored   = (bytecode.anchored_begin() && bytecode.anchored_end());
+
+    return (_valid = do_build());
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
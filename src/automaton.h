@@ -0,0 +1,148 @@
+/*
+ * automaton.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Automaton_h__
+#define __Automaton_h__
+
+#include "bytecode.h"
+
+// ---------------------------------------------------------------------------
+// ByteSet
+// ---------------------------------------------------------------------------
+
+struct ByteSet
+{
+    uint64_t bits[4];
+
+    auto clear() -> void
+    {
+        bits[0] = bits[1] = bits[2] = bits[3] = 0;
+    }
+
+    auto fill() -> void
+    {
+        bits[0] = bits[1] = bits[2] = bits[3] = ~static_cast<uint64_t>(0);
+    }
+
+    auto add(const uint8_t byte) -> void
+    {
+        bits[byte >> 6] |= (static_cast<uint64_t>(1) << (byte & 63));
+    }
+
+    auto has(const uint8_t byte) const -> bool
+    {
+        return ((bits[byte >> 6] >> (byte & 63)) & 1) != 0;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Automaton: a Thompson NFA lowered from the bytecode
+// ---------------------------------------------------------------------------
+
+class Automaton
+{
+public: // public interface
+    Automaton();
+
+    Automaton(Automaton&&) = delete;
+
+    Automaton(const Automaton&) = delete;
+
+    Automaton& operator=(Automaton&&) = delete;
+
+    Automaton& operator=(const Automaton&) = delete;
+
+    virtual ~Automaton() = default;
+
+    static constexpr uint8_t NODE_BYTE  = 0x00; // consume a byte of a set
+    static constexpr uint8_t NODE_SPLIT = 0x01; // epsilon to out and alt
+    static constexpr uint8_t NODE_STX   = 0x02; // assert start of text
+    static constexpr uint8_t NODE_ETX   = 0x03; // assert end of text
+    static constexpr uint8_t NODE_MATCH = 0x04; // accept
+    static constexpr uint8_t NODE_BOL   = 0x05; // assert start of line
+    static constexpr uint8_t NODE_EOL   = 0x06; // assert end of line
+
+    static constexpr uint32_t MAX_NODES    = 65536;
+    static constexpr uint32_t MAX_UNROLLED = 8;  // copies of a counted repetition, past which its DFA states may blow up
+
+    struct Node
+    {
+        uint8_t  type;
+        uint32_t out;
+        uint32_t alt;
+        uint32_t set;
+    };
+
+    auto build(const ByteCode& bytecode) -> bool;
+
+    auto clear() -> void;
+
+    auto valid() const -> bool
+    {
+        return _valid;
+    }
+
+    auto multiline() const -> bool
+    {
+        return _multiline;
+    }
+
+    auto rejects(const size_t size) const -> bool
+    {
+        return (size < _min_length) || ((_anchored != false) && (size > _max_length));
+    }
+
+    auto start() const -> uint32_t
+    {
+        return _start;
+    }
+
+    auto size() const -> size_t
+    {
+        return _nodes.size();
+    }
+
+    auto node(const uint32_t index) const -> const Node&
+    {
+        return _nodes[index];
+    }
+
+    auto set(const uint32_t index) const -> const ByteSet&
+    {
+        return _sets[index];
+    }
+
+protected: // protected interface
+    auto add_node(const uint8_t type, const uint32_t set) -> uint32_t;
+
+    auto add_set(const ByteSet& set) -> uint32_t;
+
+protected: // protected data
+    std::vector<Node>    _nodes;
+    std::vector<ByteSet> _sets;
+    uint32_t             _start;
+    uint64_t             _min_length;
+    uint64_t             _max_length;
+    bool                 _multiline;
+    bool                 _anchored;
+    bool                 _valid;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Automaton_h__ */
@@ -0,0 +1,225 @@
+/*
+ * batch.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <stdexcept>
+#include "batch.h"
+
+// ---------------------------------------------------------------------------
+// Batch
+// ---------------------------------------------------------------------------
+
+Batch::Batch(std::istream& istream, std::ostream& ostream, const uint32_t format, const uint32_t engine, const uint32_t flags)
+    : _istream(istream)
+    , _ostream(ostream)
+    , _format(format)
+    , _engine(engine)
+    , _flags(flags)
+    , _programs()
+    , _pattern()
+    , _subject()
+    , _output()
+    , _records(0)
+{
+    _output.reserve(BUFFER_SIZE);
+}
+
+auto Batch::parse_format(const std::string& name) -> uint32_t
+{
+    if(name == "tab") {
+        return FORMAT_TAB;
+    }
+    if(name == "length") {
+        return FORMAT_LENGTH;
+    }
+    throw std::runtime_error(std::string("invalid batch format") + ' ' + '\'' + name + '\'');
+}
+
+auto Batch::run() -> uint64_t
+{
+    uint64_t matches = 0;
+
+    while(read_record(_pattern, _subject) != false) {
+        RegExp* regexp = program(_pattern);
+        if(regexp == nullptr) {
+            result('E');
+        }
+        else if(regexp->is_match(_subject) != false) {
+            result('1');
+            ++matches;
+        }
+        else {
+            result('0');
+        }
+    }
+    flush();
+
+    return matches;
+}
+
+auto Batch::run(const std::string& pattern) -> uint64_t
+{
+    uint64_t matches = 0;
+    RegExp*  regexp  = program(pattern);
+
+    if(regexp == nullptr) {
+        throw std::runtime_error(std::string("unable to compile") + ' ' + '\'' + pattern + '\'');
+    }
+    while(read_field(_subject) != false) {
+        ++_records;
+        if(regexp->is_match(_subject) != false) {
+            result('1');
+            ++matches;
+        }
+        else {
+            result('0');
+        }
+    }
+    flush();
+
+    return matches;
+}
+
+auto Batch::read_line(std::string& line) -> bool
+{
+    if(std::getline(_istream, line)) {
+        if((line.empty() == false) && (line.back() == '\r')) {
+            line.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+auto Batch::read_field(std::string& field) -> bool
+{
+    if(_format == FORMAT_TAB) {
+        return read_line(field);
+    }
+    size_t length = 0;
+    size_t digits = 0;
+    int    chr    = 0;
+    while((chr = _istream.get()) != std::istream::traits_type::eof()) {
+        if((chr >= '0') && (chr <= '9')) {
+            length = (length * 10) + (chr - '0');
+            ++digits;
+            if(length > MAX_LENGTH) {
+                throw std::runtime_error(std::string("invalid length prefix at record") + ' ' + std::to_string(_records + 1));
+            }
+        }
+        else if((chr == ':') && (digits != 0)) {
+            break;
+        }
+        else if((chr == '\n') && (digits == 0)) {
+            continue;
+        }
+        else {
+            throw std::runtime_error(std::string("invalid length prefix at record") + ' ' + std::to_string(_records + 1));
+        }
+    }
+    if(chr == std::istream::traits_type::eof()) {
+        if(digits != 0) {
+            throw std::runtime_error(std::string("truncated record") + ' ' + std::to_string(_records + 1));
+        }
+        return false;
+    }
+    field.resize(length);
+    if(!_istream.read(&field[0], length)) {
+        throw std::runtime_error(std::string("truncated record") + ' ' + std::to_string(_records + 1));
+    }
+    return true;
+}
+
+auto Batch::read_record(std::string& pattern, std::string& subject) -> bool
+{
+    if(_format == FORMAT_TAB) {
+        if(read_line(subject) == false) {
+            return false;
+        }
+        ++_records;
+        const size_t tab = subject.find('\t');
+        if(tab == std::string::npos) {
+            throw std::runtime_error(std::string("missing tab at record") + ' ' + std::to_string(_records));
+        }
+        pattern.assign(subject, 0, tab);
+        subject.erase(0, tab + 1);
+        return true;
+    }
+    if(read_field(pattern) == false) {
+        return false;
+    }
+    ++_records;
+    if(read_field(subject) == false) {
+        throw std::runtime_error(std::string("truncated record") + ' ' + std::to_string(_records));
+    }
+    return true;
+}
+
+auto Batch::program(const std::string& pattern) -> RegExp*
+{
+    auto found = _programs.find(pattern);
+    if(found != _programs.end()) {
+        return found->second.get();
+    }
+    if(_programs.size() >= MAX_PROGRAMS) {
+        _programs.clear();
+    }
+    std::unique_ptr<RegExp> regexp(new RegExp(LogLevel::null_stream(), LogLevel::LOG_QUIET));
+    regexp->set_engine(_engine);
+    if(regexp->compile(pattern.data(), pattern.size(), _flags) == false) {
+        regexp.reset();
+    }
+    return (_programs[pattern] = std::move(regexp)).get();
+}
+
+auto Batch::result(const char result) -> void
+{
+    _output.push_back(result);
+    _output.push_back('\n');
+    /* a coprocess waits for this answer before it writes the next record, so nothing may stay buffered once the input is drained */
+    if((_output.size() >= BUFFER_SIZE) || (_istream.rdbuf()->in_avail() <= 0)) {
+        flush();
+    }
+}
+
+auto Batch::flush() -> void
+{
+    if(_output.empty() == false) {
+        _ostream.write(_output.data(), _output.size());
+        _output.clear();
+    }
+    _ostream.flush();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+/*
+ * batch.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Batch_h__
+#define __Batch_h__
+
+#include <map>
+#include "regexp.h"
+
+// ---------------------------------------------------------------------------
+// Batch: match a stream of records in a single process
+// ---------------------------------------------------------------------------
+
+class Batch
+{
+public: // public interface
+    Batch(std::istream& istream, std::ostream& ostream, const uint32_t format, const uint32_t engine, const uint32_t flags);
+
+    Batch(Batch&&) = delete;
+
+    Batch(const Batch&) = delete;
+
+    Batch& operator=(Batch&&) = delete;
+
+    Batch& operator=(const Batch&) = delete;
+
+    virtual ~Batch() = default;
+
+    static constexpr uint32_t FORMAT_TAB    = 0; // fields separated by a tab, records by a newline
+    static constexpr uint32_t FORMAT_LENGTH = 1; // each field written as "<length>:<bytes>\n"
+
+    static constexpr size_t MAX_PROGRAMS = 256;
+    static constexpr size_t BUFFER_SIZE  = 65536;
+    static constexpr size_t MAX_LENGTH   = 1073741824; // largest length prefix accepted for a field
+
+    static auto parse_format(const std::string& name) -> uint32_t;
+
+    auto run() -> uint64_t;
+
+    auto run(const std::string& pattern) -> uint64_t;
+
+protected: // protected interface
+    auto read_line(std::string& line) -> bool;
+
+    auto read_field(std::string& field) -> bool;
+
+    auto read_record(std::string& pattern, std::string& subject) -> bool;
+
+    auto program(const std::string& pattern) -> RegExp*;
+
+    auto result(const char result) -> void;
+
+    auto flush() -> void;
+
+protected: // protected data
+    std::istream&                                  _istream;
+    std::ostream&                                  _ostream;
+    const uint32_t                                 _format;
+    const uint32_t                                 _engine;
+    const uint32_t                                 _flags;
+    std::map<std::string, std::unique_ptr<RegExp>> _programs;
+    std::string                                    _pattern;
+    std::string                                    _subject;
+    std::string                                    _output;
+    uint64_t                                       _records;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Batch_h__ */
@@ -0,0 +1,1265 @@
+/*
+ * benchmark.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <regex>
+#include "benchmark.h"
+#include "regexp.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Allocations
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct Allocations
+{
+    static uint64_t count;
+};
+
+uint64_t Allocations::count = 0;
+
+}
+
+// ---------------------------------------------------------------------------
+// global allocation functions, counting the heap allocations
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+    ++Allocations::count;
+    void* pointer = ::malloc(size != 0 ? size : 1);
+    if(pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    ::free(pointer);
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Clock
+// ---------------------------------------------------------------------------
+
+namespace {
+
+using Clock     = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
+auto elapsed_ns(const TimePoint& t0, const TimePoint& t1) -> double
+{
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Random
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class Random
+{
+public: // public interface
+    Random(const uint64_t seed)
+        : _state(seed != 0 ? seed : 0x9e3779b97f4a7c15ull)
+    {
+    }
+
+    auto next() -> uint64_t
+    {
+        _state ^= (_state << 13);
+        _state ^= (_state >>  7);
+        _state ^= (_state << 17);
+        return _state;
+    }
+
+    auto below(const uint64_t bound) -> uint64_t
+    {
+        return next() % bound;
+    }
+
+    template <typename T, size_t N>
+    auto pick(const T (&array)[N]) -> const T&
+    {
+        return array[below(N)];
+    }
+
+private: // private data
+    uint64_t _state;
+};
+
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Corpus
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct Corpus
+{
+    std::string name;
+    ArgList     lines;
+    ArgList     patterns;
+    uint64_t    bytes;
+
+    auto add(const std::string& line) -> void
+    {
+        lines.push_back(line);
+        bytes += line.size();
+    }
+
+    static auto make_log(const size_t count) -> Corpus
+    {
+        static const char* const hosts[]    = { "web-01", "web-02", "db-01", "cache-07", "gw-12" };
+        static const char* const daemons[]  = { "sshd", "nginx", "kernel", "cron", "postfix" };
+        static const char* const levels[]   = { "INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR" };
+        static const char* const messages[] = {
+            "Accepted publickey for user",
+            "connection closed by remote host",
+            "GET /api/v1/items HTTP/1.1 200",
+            "POST /api/v1/login HTTP/1.1 401",
+            "session opened for user",
+            "queue flushed after timeout",
+            "out of memory: killed process",
+        };
+
+        Corpus corpus { "log", {}, { "ERROR", "^2025.*sshd.*Accepted", "port 5+$", "user4?2", "GET|POST|PUT|DELETE" }, 0 };
+        Random random(0x1badb002ull);
+        char   buffer[256];
+
+        for(size_t index = 0; index < count; ++index) {
+            const int length = ::snprintf ( buffer, sizeof(buffer)
+                                          , "2025-%02d-%02dT%02d:%02d:%02d.%03dZ %s %s[%d]: %s %s%d from 10.%d.%d.%d port %d"
+                                          , static_cast<int>(1 + random.below(12))
+                                          , static_cast<int>(1 + random.below(28))
+                                          , static_cast<int>(random.below(24))
+                                          , static_cast<int>(random.below(60))
+                                          , static_cast<int>(random.below(60))
+                                          , static_cast<int>(random.below(1000))
+                                          , random.pick(hosts)
+                                          , random.pick(daemons)
+                                          , static_cast<int>(100 + random.below(30000))
+                                          , random.pick(levels)
+                                          , random.pick(messages)
+                                          , static_cast<int>(random.below(100))
+                                          , static_cast<int>(random.below(256))
+                                          , static_cast<int>(random.below(256))
+                                          , static_cast<int>(random.below(256))
+                                          , static_cast<int>(1024 + random.below(64000)) );
+            corpus.add(std::string(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1)));
+        }
+        return corpus;
+    }
+
+    static auto make_text(const size_t count) -> Corpus
+    {
+        static const char* const words[] = {
+            "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+            "elit", "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore",
+            "et", "dolore", "magna", "aliqua", "enim", "ad", "minim", "veniam",
+            "quis", "nostrud", "exercitation", "ullamco", "laboris", "nisi",
+        };
+
+        Corpus corpus { "text", {}, { "lorem", "q.*z$", "^e.*e.*e", "a+b", "veniam.*quis" }, 0 };
+        Random random(0xcafebabeull);
+
+        for(size_t index = 0; index < count; ++index) {
+            std::string line;
+            const size_t length = 40 + random.below(80);
+            while(line.size() < length) {
+                if(line.empty() == false) {
+                    line += ' ';
+                }
+                if(random.below(8) == 0) {
+                    for(uint64_t letters = 3 + random.below(6); letters != 0; --letters) {
+                        line += static_cast<char>('a' + random.below(26));
+                    }
+                }
+                else {
+                    line += random.pick(words);
+                }
+            }
+            corpus.add(line);
+        }
+        return corpus;
+    }
+
+    static auto make_utf8(const size_t count) -> Corpus
+    {
+        static const char* const words[] = {
+            "café", "crème", "brûlée", "déjà", "vu", "naïve", "façade", "élève",
+            "garçon", "über", "straße", "mañana", "año", "piñata", "smörgåsbord",
+            "fjörð", "ñandú", "€uro", "zoë", "coöperate", "résumé", "à", "la", "carte",
+        };
+
+        Corpus corpus { "utf8", {}, { "café", "^é.*e$", "r.sum.", "ñ.*ú$", "ö+r" }, 0 };
+        Random random(0xdecafbadull);
+
+        for(size_t index = 0; index < count; ++index) {
+            std::string line;
+            const size_t length = 40 + random.below(80);
+            while(line.size() < length) {
+                if(line.empty() == false) {
+                    line += ' ';
+                }
+                line += random.pick(words);
+            }
+            corpus.add(line);
+        }
+        return corpus;
+    }
+
+    static auto make_pathological(const size_t count) -> Corpus
+    {
+        Corpus corpus { "pathological", {}, { "a*a*a*b", "^.*a.*a.*b$", "a?a?a?a?aaaa$" }, 0 };
+
+        for(size_t index = 0; index < count; ++index) {
+            corpus.add(std::string(24 + (index % 8), 'a'));
+        }
+        return corpus;
+    }
+
+    static auto make_patterns(const size_t count) -> Corpus
+    {
+        static const char* const atoms[]       = { "a", "b", "x", "0", " ", ".", "\\.", "\\t", "lorem", "ipsum", "ERROR" };
+        static const char* const quantifiers[] = { "", "", "", "?", "*", "+" };
+
+        Corpus corpus { "patterns", {}, {}, 0 };
+        Random random(0x5eed1e55ull);
+
+        for(size_t index = 0; index < count; ++index) {
+            std::string pattern;
+            if(random.below(4) == 0) {
+                pattern += '^';
+            }
+            for(uint64_t atoms_count = 1 + random.below(16); atoms_count != 0; --atoms_count) {
+                pattern += random.pick(atoms);
+                pattern += random.pick(quantifiers);
+            }
+            if(random.below(4) == 0) {
+                pattern += '$';
+            }
+            if(random.below(16) == 0) {
+                pattern.insert(random.below(pattern.size()), random.below(2) == 0 ? "*" : "\\z");
+            }
+            corpus.add(pattern);
+        }
+        return corpus;
+    }
+
+    static auto make_file(const std::string& filename) -> Corpus
+    {
+        Corpus        corpus { filename, {}, {}, 0 };
+        std::ifstream stream(filename);
+        std::string   line;
+
+        if(stream.is_open() == false) {
+            throw std::runtime_error(std::string("unable to open corpus") + ' ' + '\'' + filename + '\'');
+        }
+        while(std::getline(stream, line)) {
+            corpus.add(line);
+        }
+        return corpus;
+    }
+
+    static auto make(const std::string& name) -> Corpus
+    {
+        if(name == "log") {
+            return make_log(20000);
+        }
+        if(name == "text") {
+            return make_text(20000);
+        }
+        if(name == "utf8") {
+            return make_utf8(20000);
+        }
+        if(name == "pathological") {
+            return make_pathological(400);
+        }
+        if(name == "patterns") {
+            return make_patterns(20000);
+        }
+        return make_file(name);
+    }
+};
+
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Latencies
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class Latencies
+{
+public: // public interface
+    Latencies()
+        : _samples()
+    {
+    }
+
+    auto reserve(const size_t count) -> void
+    {
+        _samples.reserve(count);
+    }
+
+    auto add(const double sample) -> void
+    {
+        _samples.push_back(sample);
+    }
+
+    auto percentile(const double rank) -> double
+    {
+        if(_samples.empty()) {
+            return 0.0;
+        }
+        const size_t count = _samples.size();
+        const size_t index = static_cast<size_t>(std::ceil(rank * static_cast<double>(count)));
+        const size_t nth   = std::min(count, std::max(index, static_cast<size_t>(1))) - 1;
+        std::nth_element(_samples.begin(), _samples.begin() + nth, _samples.end());
+        return _samples[nth];
+    }
+
+private: // private data
+    std::vector<double> _samples;
+};
+
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Runner
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct Runner
+{
+    static auto engines() -> ArgList
+    {
+        ArgList engines;
+        for(uint32_t engine = 0; engine < Engine::ENGINE_COUNT; ++engine) {
+            engines.push_back(Engine::name(engine));
+        }
+        return engines;
+    }
+
+    static auto make_regexp(const std::string& engine) -> std::unique_ptr<RegExp>
+    {
+        std::unique_ptr<RegExp> regexp(new RegExp(std::cout, LogLevel::LOG_QUIET));
+        if(engine != "batch") {
+            regexp->set_engine(Engine::parse(engine));
+        }
+        return regexp;
+    }
+
+    static auto run(RegExp& regexp, const std::string& string) -> bool
+    {
+        if(Benchmark::earliest != false) {
+            return regexp.is_match(string);
+        }
+        return regexp.execute(string);
+    }
+
+    static auto compile(const std::string& engine, const std::string& pattern) -> double
+    {
+        constexpr int count  = 1000;
+        auto          regexp(make_regexp(engine));
+
+        const TimePoint t0 = Clock::now();
+        for(int index = 0; index < count; ++index) {
+            if(regexp->compile(pattern.data(), pattern.size(), Benchmark::flags) == false) {
+                throw std::runtime_error(std::string("unable to compile") + ' ' + '\'' + pattern + '\'');
+            }
+        }
+        const TimePoint t1 = Clock::now();
+
+        return elapsed_ns(t0, t1) / static_cast<double>(count);
+    }
+
+    static auto measure(const std::string& suite, const std::string& engine, const Corpus& corpus, const std::string& pattern, PerfCounters& counters) -> BenchResult
+    {
+        constexpr size_t       batch_size = 64;
+        BenchResult            result { suite, engine, corpus.name, pattern, 0, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, NAN, false, false, {} };
+        auto                   regexp(make_regexp(engine));
+        Latencies              latencies;
+        std::vector<Input>     inputs;
+        std::vector<uint64_t>  bitset((corpus.lines.size() + 63) / 64);
+        std::vector<Line>      found;
+        std::string            buffer;
+        const bool             batch = (engine == "batch");
+        const bool             lines = ((batch == false) && ((Benchmark::flags & CompileFlags::FLAG_MULTILINE) != 0));
+
+        result.compile_ns = compile(engine, pattern);
+        if(regexp->compile(pattern.data(), pattern.size(), Benchmark::flags) == false) {
+            throw std::runtime_error(std::string("unable to compile") + ' ' + '\'' + pattern + '\'');
+        }
+        for(auto& line : corpus.lines) {
+            inputs.push_back(Input { line.data(), line.size() });
+            buffer.append(line).push_back('\n');
+        }
+        auto throughput_pass = [&]() -> void
+        {
+            const uint64_t allocations = Allocations::count;
+            counters.start();
+            const TimePoint t0 = Clock::now();
+            if(batch != false) {
+                result.matches += regexp->execute_batch(inputs.data(), inputs.size(), bitset.data());
+            }
+            else if(lines != false) {
+                result.matches += regexp->scan_lines(buffer.data(), buffer.size(), found);
+            }
+            else {
+                for(auto& line : corpus.lines) {
+                    if(run(*regexp, line) != false) {
+                        ++result.matches;
+                    }
+                }
+            }
+            const TimePoint t1 = Clock::now();
+            counters.stop();
+            result.seconds     += elapsed_ns(t0, t1) * 1e-9;
+            result.bytes       += corpus.bytes;
+            result.executions  += corpus.lines.size();
+            result.allocations += Allocations::count - allocations;
+        };
+
+        auto latency_pass = [&]() -> void
+        {
+            if(batch != false) {
+                for(size_t index = 0; index < inputs.size(); index += batch_size) {
+                    const size_t    count = std::min(batch_size, inputs.size() - index);
+                    const TimePoint t0    = Clock::now();
+                    static_cast<void>(regexp->execute_batch(&inputs[index], count, bitset.data()));
+                    const TimePoint t1    = Clock::now();
+                    for(size_t sample = 0; sample < count; ++sample) {
+                        latencies.add(elapsed_ns(t0, t1) / static_cast<double>(count));
+                    }
+                }
+            }
+            else if(lines != false) {
+                const TimePoint t0 = Clock::now();
+                static_cast<void>(regexp->scan_lines(buffer.data(), buffer.size(), found));
+                const TimePoint t1 = Clock::now();
+                for(size_t sample = 0; sample < corpus.lines.size(); ++sample) {
+                    latencies.add(elapsed_ns(t0, t1) / static_cast<double>(corpus.lines.size()));
+                }
+            }
+            else {
+                for(auto& line : corpus.lines) {
+                    const TimePoint t0 = Clock::now();
+                    static_cast<void>(run(*regexp, line));
+                    const TimePoint t1 = Clock::now();
+                    latencies.add(elapsed_ns(t0, t1));
+                }
+            }
+        };
+
+        latency_pass();
+        counters.reset();
+        latencies = Latencies();
+        latencies.reserve(corpus.lines.size() * Benchmark::rounds);
+        for(uint32_t round = 0; round < Benchmark::rounds; ++round) {
+            throughput_pass();
+            latency_pass();
+        }
+        result.p50_ns       = latencies.percentile(0.500);
+        result.p99_ns       = latencies.percentile(0.990);
+        result.p999_ns      = latencies.percentile(0.999);
+        result.has_counters = counters.available();
+        for(int counter = 0; counter < PerfCounters::CNT_COUNT; ++counter) {
+            result.counters[counter] = counters.value(counter);
+        }
+        return result;
+    }
+
+    static auto throughput(BenchResults& results, PerfCounters& counters) -> void
+    {
+        ArgList names(Benchmark::corpora);
+
+        if(names.empty()) {
+            names = ArgList { "log", "text", "pathological" };
+        }
+        for(auto& name : names) {
+            Corpus corpus(Corpus::make(name));
+            if(Benchmark::patterns.empty() == false) {
+                corpus.patterns = Benchmark::patterns;
+            }
+            if(corpus.patterns.empty()) {
+                throw std::runtime_error(std::string("no pattern for corpus") + ' ' + '\'' + name + '\'' + ", use --pattern=PATTERN");
+            }
+            ArgList modes(engines());
+            modes.push_back("batch");
+            for(auto& engine : modes) {
+                for(auto& pattern : corpus.patterns) {
+                    results.push_back(measure("throughput", engine, corpus, pattern, counters));
+                    Report::print(std::cout, results.back());
+                }
+            }
+        }
+    }
+
+    static auto compilation(BenchResults& results, PerfCounters& counters) -> void
+    {
+        ArgList names(Benchmark::corpora);
+
+        if(names.empty()) {
+            names = ArgList { "patterns" };
+        }
+        for(auto& name : names) {
+            Corpus corpus(Corpus::make(name));
+            if(Benchmark::patterns.empty() == false) {
+                corpus.lines = Benchmark::patterns;
+                corpus.bytes = 0;
+                for(auto& line : corpus.lines) {
+                    corpus.bytes += line.size();
+                }
+            }
+            BenchResult result { "compile", "compiler", corpus.name, std::to_string(corpus.lines.size()) + " patterns", 0, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, NAN, false, false, {} };
+            RegExp      regexp(std::cout, LogLevel::LOG_QUIET);
+            Latencies   latencies;
+
+            auto throughput_pass = [&]() -> void
+            {
+                counters.start();
+                const TimePoint t0 = Clock::now();
+                for(auto& line : corpus.lines) {
+                    if(regexp.compile(line.data(), line.size(), Benchmark::flags) != false) {
+                        ++result.matches;
+                    }
+                }
+                const TimePoint t1 = Clock::now();
+                counters.stop();
+                result.seconds    += elapsed_ns(t0, t1) * 1e-9;
+                result.bytes      += corpus.bytes;
+                result.executions += corpus.lines.size();
+            };
+
+            auto latency_pass = [&]() -> void
+            {
+                for(auto& line : corpus.lines) {
+                    const TimePoint t0 = Clock::now();
+                    static_cast<void>(regexp.compile(line.data(), line.size(), Benchmark::flags));
+                    const TimePoint t1 = Clock::now();
+                    latencies.add(elapsed_ns(t0, t1));
+                }
+            };
+
+            latency_pass();
+            counters.reset();
+            latencies = Latencies();
+            latencies.reserve(corpus.lines.size() * Benchmark::rounds);
+            for(uint32_t round = 0; round < Benchmark::rounds; ++round) {
+                throughput_pass();
+                latency_pass();
+            }
+            result.compile_ns   = (result.executions != 0 ? result.seconds * 1e9 / static_cast<double>(result.executions) : 0.0);
+            result.p50_ns       = latencies.percentile(0.500);
+            result.p99_ns       = latencies.percentile(0.990);
+            result.p999_ns      = latencies.percentile(0.999);
+            result.has_counters = counters.available();
+            for(int counter = 0; counter < PerfCounters::CNT_COUNT; ++counter) {
+                result.counters[counter] = counters.value(counter);
+            }
+            results.push_back(result);
+            Report::print_compile(std::cout, results.back());
+        }
+    }
+
+    struct Case
+    {
+        const char* name;
+        uint64_t    scales[16];
+        auto        (*pattern)(const uint64_t n) -> std::string;
+        auto        (*subject)(const uint64_t n) -> std::string;
+    };
+
+    static auto repeat(const char* string, const uint64_t n) -> std::string
+    {
+        std::string result;
+        for(uint64_t index = 0; index < n; ++index) {
+            result += string;
+        }
+        return result;
+    }
+
+    static auto scatter(const char first, const char other, const uint64_t n) -> std::string
+    {
+        std::string result;
+        uint32_t    state = 1;
+        for(uint64_t index = 0; index < n; ++index) {
+            state  = (state * 1103515245u) + 12345u;
+            result += ((state >> 16) & 3) == 0 ? first : other;
+        }
+        return result;
+    }
+
+    static auto cases() -> const std::vector<Case>&
+    {
+        static const std::vector<Case> cases = {
+            {
+                "optional", { 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32 },
+                [](const uint64_t n) -> std::string { return "^" + repeat("a?", n) + repeat("a", n) + "$"; },
+                [](const uint64_t n) -> std::string { return repeat("a", n); },
+            },
+            {
+                "stacked", { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 },
+                [](const uint64_t n) -> std::string { return ".*x.*y.*z"; },
+                [](const uint64_t n) -> std::string { return repeat("xy", n / 2); },
+            },
+            {
+                "repeated", { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 },
+                [](const uint64_t n) -> std::string { return "a*a*a*a*c"; },
+                [](const uint64_t n) -> std::string { return repeat("a", n); },
+            },
+            {
+                "possessive", { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 },
+                [](const uint64_t n) -> std::string { return "a*+a*+a*+a*+c"; },
+                [](const uint64_t n) -> std::string { return repeat("a", n); },
+            },
+            {
+                "fields", { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 },
+                [](const uint64_t n) -> std::string { return "^.*,.*,.*,.*;$"; },
+                [](const uint64_t n) -> std::string { return repeat("a,", n / 2); },
+            },
+            {
+                "counted", { 8, 16, 32, 64, 128, 256, 512, 1024 },
+                [](const uint64_t n) -> std::string { return "x.{" + std::to_string(n) + "}y"; },
+                [](const uint64_t n) -> std::string { return scatter('x', 'a', 65536); },
+            },
+        };
+        return cases;
+    }
+
+    static auto pathological(BenchResults& results, PerfCounters& counters) -> void
+    {
+        constexpr double min_ns = 10e6;
+
+        auto time_runs = [&](BenchResult& result, const std::string& subject, const std::function<bool(const std::string&)>& run) -> void
+        {
+            counters.reset();
+            const TimePoint t0 = Clock::now();
+            TimePoint       t1 = t0;
+            do {
+                counters.start();
+                if(run(subject) != false) {
+                    ++result.matches;
+                }
+                counters.stop();
+                result.bytes += subject.size();
+                ++result.executions;
+                t1 = Clock::now();
+            } while(elapsed_ns(t0, t1) < min_ns);
+            result.seconds      = elapsed_ns(t0, t1) * 1e-9;
+            result.p50_ns       = elapsed_ns(t0, t1) / static_cast<double>(result.executions);
+            result.p99_ns       = result.p50_ns;
+            result.p999_ns      = result.p50_ns;
+            result.exceeded     = (result.p50_ns > Benchmark::budget * 1e9);
+            result.has_counters = counters.available();
+            for(int counter = 0; counter < PerfCounters::CNT_COUNT; ++counter) {
+                result.counters[counter] = counters.value(counter);
+            }
+        };
+
+        auto measure_regexp = [&](BenchResult& result, const std::string& subject) -> void
+        {
+            auto regexp(make_regexp(result.engine));
+
+            result.compile_ns = compile(result.engine, result.pattern);
+            if(regexp->compile(result.pattern.data(), result.pattern.size(), Benchmark::flags) == false) {
+                throw std::runtime_error(std::string("unable to compile") + ' ' + '\'' + result.pattern + '\'');
+            }
+            time_runs(result, subject, [&](const std::string& string) -> bool
+            {
+                return run(*regexp, string);
+            });
+        };
+
+        auto measure_stdregex = [&](BenchResult& result, const std::string& subject) -> void
+        {
+            const TimePoint t0 = Clock::now();
+            const std::regex regex(result.pattern, std::regex::ECMAScript);
+            const TimePoint t1 = Clock::now();
+
+            result.compile_ns = elapsed_ns(t0, t1);
+            time_runs(result, subject, [&](const std::string& string) -> bool
+            {
+                return std::regex_search(string, regex);
+            });
+        };
+
+        ArgList engines(Runner::engines());
+        engines.push_back("std::regex");
+        for(auto& current : cases()) {
+            for(auto& engine : engines) {
+                double   prev_ns    = 0.0;
+                uint64_t prev_scale = 0;
+                for(size_t index = 0; index < 16; ++index) {
+                    const uint64_t scale = current.scales[index];
+                    const uint64_t next  = (index < 15 ? current.scales[index + 1] : 0);
+                    if(scale == 0) {
+                        break;
+                    }
+                    const std::string subject(current.subject(scale));
+                    BenchResult result { "pathological", engine, current.name, current.pattern(scale), scale, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, NAN, false, false, {} };
+                    try {
+                        if(engine == "std::regex") {
+                            measure_stdregex(result, subject);
+                        }
+                        else {
+                            measure_regexp(result, subject);
+                        }
+                    }
+                    catch(const std::regex_error& e) {
+                        std::cout << engine << ' ' << current.name << ' ' << scale << ": " << e.what() << std::endl;
+                        break;
+                    }
+                    if((prev_scale != 0) && (prev_ns > 0.0)) {
+                        result.growth = std::log(result.p50_ns / prev_ns) / std::log(static_cast<double>(scale) / static_cast<double>(prev_scale));
+                    }
+                    if((next != 0) && std::isfinite(result.growth)) {
+                        const double predicted_ns = result.p50_ns * std::pow(static_cast<double>(next) / static_cast<double>(scale), std::max(result.growth, 1.0));
+                        if(predicted_ns > Benchmark::budget * 4e9) {
+                            result.exceeded = true;
+                        }
+                    }
+                    prev_ns    = result.p50_ns;
+                    prev_scale = scale;
+                    results.push_back(result);
+                    Report::print_growth(std::cout, results.back());
+                    if(result.exceeded != false) {
+                        break;
+                    }
+                }
+            }
+        }
+        Report::check_agreement(std::cout, results);
+    }
+
+    struct Report
+    {
+        static auto header_growth(std::ostream& stream) -> void
+        {
+            stream << std::left
+                   << std::setw(12) << "engine"   << ' '
+                   << std::setw(10) << "case"     << ' '
+                   << std::right
+                   << std::setw(6)  << "n"        << ' '
+                   << std::setw(12) << "time/run" << ' '
+                   << std::setw(8)  << "growth"   << ' '
+                   << std::setw(8)  << "match"    << ' '
+                   << std::setw(10) << "cyc/B"    << std::endl;
+        }
+
+        static auto print_growth(std::ostream& stream, const BenchResult& result) -> void
+        {
+            char growth[32];
+
+            if(std::isfinite(result.growth)) {
+                ::snprintf(growth, sizeof(growth), "n^%.1f", result.growth);
+            }
+            else {
+                ::snprintf(growth, sizeof(growth), "-");
+            }
+            stream << std::left
+                   << std::setw(12) << result.engine  << ' '
+                   << std::setw(10) << result.corpus  << ' '
+                   << std::right
+                   << std::setw(6)  << result.scale   << ' '
+                   << std::setw(12) << duration(result.p50_ns) << ' '
+                   << std::setw(8)  << growth << ' '
+                   << std::setw(8)  << (result.matches != 0 ? "yes" : "no") << ' '
+                   << std::setw(10) << per_byte(result, PerfCounters::CNT_CYCLES)
+                   << (result.exceeded != false ? "  (budget exceeded, stop scaling)" : "") << std::endl;
+        }
+
+        static auto header_compile(std::ostream& stream) -> void
+        {
+            stream << std::left
+                   << std::setw(14) << "corpus"     << ' '
+                   << std::setw(16) << "patterns"   << ' '
+                   << std::right
+                   << std::setw(12) << "compiles/s" << ' '
+                   << std::setw(10) << "MB/s"       << ' '
+                   << std::setw(10) << "mean"       << ' '
+                   << std::setw(10) << "p50"        << ' '
+                   << std::setw(10) << "p99"        << ' '
+                   << std::setw(10) << "p999"       << ' '
+                   << std::setw(8)  << "invalid"    << ' '
+                   << std::setw(10) << "cyc/B"      << std::endl;
+        }
+
+        static auto print_compile(std::ostream& stream, const BenchResult& result) -> void
+        {
+            const double invalid = (result.executions != 0 ? 100.0 * static_cast<double>(result.executions - result.matches) / static_cast<double>(result.executions) : 0.0);
+
+            stream << std::left
+                   << std::setw(14) << result.corpus.substr(0, 14)  << ' '
+                   << std::setw(16) << result.pattern.substr(0, 16) << ' '
+                   << std::right << std::fixed << std::setprecision(0)
+                   << std::setw(12) << Report::execs_per_sec(result) << ' '
+                   << std::setw(10) << std::setprecision(1) << Report::mb_per_sec(result) << ' '
+                   << std::setw(10) << duration(result.compile_ns)   << ' '
+                   << std::setw(10) << duration(result.p50_ns)       << ' '
+                   << std::setw(10) << duration(result.p99_ns)       << ' '
+                   << std::setw(10) << duration(result.p999_ns)      << ' '
+                   << std::setw(7)  << invalid << '%' << ' '
+                   << std::setw(10) << per_byte(result, PerfCounters::CNT_CYCLES) << std::endl;
+        }
+
+        static auto check_agreement(std::ostream& stream, const BenchResults& results) -> void
+        {
+            for(auto& lhs : results) {
+                for(auto& rhs : results) {
+                    if((&lhs < &rhs)
+                    && (lhs.corpus == rhs.corpus)
+                    && (lhs.scale  == rhs.scale)
+                    && ((lhs.matches != 0) != (rhs.matches != 0))) {
+                        stream << "warning: " << lhs.engine << " and " << rhs.engine << " disagree on " << lhs.corpus << " n=" << lhs.scale << std::endl;
+                    }
+                }
+            }
+        }
+
+        static auto per_byte(const BenchResult& result, const int counter) -> std::string
+        {
+            char buffer[32];
+            if((result.has_counters == false) || (result.bytes == 0)) {
+                return "-";
+            }
+            ::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(result.counters[counter]) / static_cast<double>(result.bytes));
+            return buffer;
+        }
+
+        static auto duration(const double ns) -> std::string
+        {
+            char buffer[32];
+            if(ns >= 1e9) {
+                ::snprintf(buffer, sizeof(buffer), "%.2fs", ns * 1e-9);
+            }
+            else if(ns >= 1e6) {
+                ::snprintf(buffer, sizeof(buffer), "%.2fms", ns * 1e-6);
+            }
+            else if(ns >= 1e3) {
+                ::snprintf(buffer, sizeof(buffer), "%.2fus", ns * 1e-3);
+            }
+            else {
+                ::snprintf(buffer, sizeof(buffer), "%.0fns", ns);
+            }
+            return buffer;
+        }
+
+        static auto header(std::ostream& stream) -> void
+        {
+            stream << std::left
+                   << std::setw(10) << "engine"   << ' '
+                   << std::setw(14) << "corpus"   << ' '
+                   << std::setw(24) << "pattern"  << ' '
+                   << std::right
+                   << std::setw(10) << "compile"  << ' '
+                   << std::setw(10) << "MB/s"     << ' '
+                   << std::setw(12) << "match/s"  << ' '
+                   << std::setw(10) << "p50"      << ' '
+                   << std::setw(10) << "p99"      << ' '
+                   << std::setw(10) << "p999"     << ' '
+                   << std::setw(10) << "cyc/B"    << ' '
+                   << std::setw(10) << "bmiss/B"  << ' '
+                   << std::setw(8)  << "allocs"   << std::endl;
+        }
+
+        static auto print(std::ostream& stream, const BenchResult& result) -> void
+        {
+            stream << std::left
+                   << std::setw(10) << result.engine  << ' '
+                   << std::setw(14) << result.corpus.substr(0, 14)  << ' '
+                   << std::setw(24) << result.pattern.substr(0, 24) << ' '
+                   << std::right << std::fixed << std::setprecision(1)
+                   << std::setw(10) << duration(result.compile_ns)  << ' '
+                   << std::setw(10) << Report::mb_per_sec(result)   << ' '
+                   << std::setw(12) << std::setprecision(0) << Report::matches_per_sec(result) << ' '
+                   << std::setw(10) << duration(result.p50_ns)      << ' '
+                   << std::setw(10) << duration(result.p99_ns)      << ' '
+                   << std::setw(10) << duration(result.p999_ns)     << ' '
+                   << std::setw(10) << per_byte(result, PerfCounters::CNT_CYCLES) << ' '
+                   << std::setw(10) << per_byte(result, PerfCounters::CNT_BRANCH_MISSES) << ' '
+                   << std::setw(8)  << result.allocations << std::endl;
+        }
+
+        static auto mb_per_sec(const BenchResult& result) -> double
+        {
+            return (result.seconds > 0.0 ? static_cast<double>(result.bytes) / result.seconds / 1e6 : 0.0);
+        }
+
+        static auto matches_per_sec(const BenchResult& result) -> double
+        {
+            return (result.seconds > 0.0 ? static_cast<double>(result.matches) / result.seconds : 0.0);
+        }
+
+        static auto execs_per_sec(const BenchResult& result) -> double
+        {
+            return (result.seconds > 0.0 ? static_cast<double>(result.executions) / result.seconds : 0.0);
+        }
+    };
+};
+
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Json
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct Json
+{
+    static auto string(std::ostream& stream, const std::string& value) -> void
+    {
+        stream << '"';
+        for(const char character : value) {
+            switch(character) {
+                case '"':
+                    stream << '\\' << '"';
+                    break;
+                case '\\':
+                    stream << '\\' << '\\';
+                    break;
+                case '\n':
+                    stream << '\\' << 'n';
+                    break;
+                case '\r':
+                    stream << '\\' << 'r';
+                    break;
+                case '\t':
+                    stream << '\\' << 't';
+                    break;
+                default:
+                    if(static_cast<uint8_t>(character) < 0x20) {
+                        char buffer[8];
+                        ::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(character));
+                        stream << buffer;
+                    }
+                    else {
+                        stream << character;
+                    }
+                    break;
+            }
+        }
+        stream << '"';
+    }
+
+    static auto number(std::ostream& stream, const double value) -> void
+    {
+        if(std::isfinite(value)) {
+            stream << value;
+        }
+        else {
+            stream << "null";
+        }
+    }
+
+    static auto per_byte(std::ostream& stream, const BenchResult& result, const int counter) -> void
+    {
+        if((result.has_counters != false) && (result.bytes != 0)) {
+            number(stream, static_cast<double>(result.counters[counter]) / static_cast<double>(result.bytes));
+        }
+        else {
+            stream << "null";
+        }
+    }
+
+    static auto write(std::ostream& stream, const BenchResults& results) -> void
+    {
+        const auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        stream << std::setprecision(6) << std::defaultfloat;
+        stream << '{' << std::endl;
+        stream << "  \"timestamp\": " << timestamp << ',' << std::endl;
+        stream << "  \"rounds\": " << Benchmark::rounds << ',' << std::endl;
+        stream << "  \"results\": [" << std::endl;
+        for(auto& result : results) {
+            stream << "    {";
+            stream << " \"suite\": ";           string(stream, result.suite);
+            stream << ", \"engine\": ";         string(stream, result.engine);
+            stream << ", \"corpus\": ";         string(stream, result.corpus);
+            stream << ", \"pattern\": ";        string(stream, result.pattern);
+            stream << ", \"scale\": "           << result.scale;
+            stream << ", \"bytes\": "           << result.bytes;
+            stream << ", \"executions\": "      << result.executions;
+            stream << ", \"matches\": "         << result.matches;
+            stream << ", \"allocations\": "     << result.allocations;
+            stream << ", \"compile_ns\": ";     number(stream, result.compile_ns);
+            stream << ", \"seconds\": ";        number(stream, result.seconds);
+            stream << ", \"mb_per_sec\": ";     number(stream, Runner::Report::mb_per_sec(result));
+            stream << ", \"matches_per_sec\": "; number(stream, Runner::Report::matches_per_sec(result));
+            stream << ", \"execs_per_sec\": ";  number(stream, Runner::Report::execs_per_sec(result));
+            stream << ", \"p50_ns\": ";         number(stream, result.p50_ns);
+            stream << ", \"p99_ns\": ";         number(stream, result.p99_ns);
+            stream << ", \"p999_ns\": ";        number(stream, result.p999_ns);
+            stream << ", \"growth\": ";         number(stream, result.growth);
+            stream << ", \"exceeded\": "        << (result.exceeded != false ? "true" : "false");
+            stream << ", \"cycles_per_byte\": ";        per_byte(stream, result, PerfCounters::CNT_CYCLES);
+            stream << ", \"instructions_per_byte\": ";  per_byte(stream, result, PerfCounters::CNT_INSTRUCTIONS);
+            stream << ", \"branches_per_byte\": ";      per_byte(stream, result, PerfCounters::CNT_BRANCHES);
+            stream << ", \"branch_misses_per_byte\": "; per_byte(stream, result, PerfCounters::CNT_BRANCH_MISSES);
+            stream << " }" << (&result != &results.back() ? "," : "") << std::endl;
+        }
+        stream << "  ]" << std::endl;
+        stream << '}' << std::endl;
+    }
+};
+
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+std::string Benchmark::arg0     = "pico-regex-bench";
+std::string Benchmark::suite    = "throughput";
+std::string Benchmark::json     = "";
+ArgList     Benchmark::corpora  = {};
+ArgList     Benchmark::patterns = {};
+uint32_t    Benchmark::rounds   = 3;
+double      Benchmark::budget   = 1.0;
+uint32_t    Benchmark::flags    = 0;
+bool        Benchmark::earliest = false;
+bool        Benchmark::perf     = false;
+
+auto Benchmark::init(const ArgList& args) -> bool
+{
+    auto has_value = [](const std::string& arg, const std::string& option) -> bool
+    {
+        return arg.compare(0, option.size(), option) == 0;
+    };
+
+    auto get_value = [](const std::string& arg, const std::string& option) -> std::string
+    {
+        return arg.substr(option.size());
+    };
+
+    auto do_init = [&]() -> bool
+    {
+        int argi = -1;
+        for(auto& arg : args) {
+            if(++argi == 0) {
+                Benchmark::arg0 = arg;
+                continue;
+            }
+            else if(arg == "-h") {
+                return false;
+            }
+            else if(arg == "--help") {
+                return false;
+            }
+            else if(arg == "--perf") {
+                Benchmark::perf = true;
+            }
+            else if(arg == "--ignore-case") {
+                Benchmark::flags |= CompileFlags::FLAG_ICASE;
+            }
+            else if(arg == "--utf8") {
+                Benchmark::flags |= CompileFlags::FLAG_UTF8;
+            }
+            else if(arg == "--multiline") {
+                Benchmark::flags |= CompileFlags::FLAG_MULTILINE;
+            }
+            else if(arg == "--is-match") {
+                Benchmark::earliest = true;
+            }
+            else if(has_value(arg, "--suite=")) {
+                Benchmark::suite = get_value(arg, "--suite=");
+            }
+            else if(has_value(arg, "--json=")) {
+                Benchmark::json = get_value(arg, "--json=");
+            }
+            else if(has_value(arg, "--corpus=")) {
+                Benchmark::corpora.push_back(get_value(arg, "--corpus="));
+            }
+            else if(has_value(arg, "--pattern=")) {
+                Benchmark::patterns.push_back(get_value(arg, "--pattern="));
+            }
+            else if(has_value(arg, "--rounds=")) {
+                Benchmark::rounds = std::max(1, std::atoi(get_value(arg, "--rounds=").c_str()));
+            }
+            else if(has_value(arg, "--budget=")) {
+                Benchmark::budget = std::max(0.001, std::atof(get_value(arg, "--budget=").c_str()));
+            }
+            else {
+                throw std::runtime_error(std::string("invalid argument") + ' ' + '\'' + arg + '\'');
+            }
+        }
+        return true;
+    };
+
+    return do_init();
+}
+
+auto Benchmark::main(const ArgList& args) -> void
+{
+    auto do_main = [&](std::ostream& stream) -> void
+    {
+        BenchResults results;
+        PerfCounters counters;
+
+        if(Benchmark::perf != false) {
+            if(counters.open() == false) {
+                stream << "hardware counters are not available, continuing without them" << std::endl;
+            }
+        }
+        if(Benchmark::suite == "throughput") {
+            Runner::Report::header(stream);
+            Runner::throughput(results, counters);
+        }
+        else if(Benchmark::suite == "pathological") {
+            Runner::Report::header_growth(stream);
+            Runner::pathological(results, counters);
+        }
+        else if(Benchmark::suite == "compile") {
+            Runner::Report::header_compile(stream);
+            Runner::compilation(results, counters);
+        }
+        else {
+            throw std::runtime_error(std::string("invalid suite") + ' ' + '\'' + Benchmark::suite + '\'');
+        }
+        if(Benchmark::json.empty() == false) {
+            std::ofstream output(Benchmark::json);
+            if(output.is_open() == false) {
+                throw std::runtime_error(std::string("unable to open") + ' ' + '\'' + Benchmark::json + '\'');
+            }
+            Json::write(output, results);
+        }
+    };
+
+    return do_main(std::cout);
+}
+
+auto Benchmark::help(const ArgList& args) -> void
+{
+    auto program_name = []() -> const char*
+    {
+        const char* arg = Benchmark::arg0.c_str();
+        const char* sep = ::strrchr(arg, '/');
+        if(sep != nullptr) {
+            arg = (sep + 1);
+        }
+        return arg;
+    };
+
+    auto do_help = [&](std::ostream& stream) -> void
+    {
+        stream << "Usage: " << program_name() << " [OPTIONS...]"                                  << std::endl;
+        stream << ""                                                                              << std::endl;
+        stream << "Options:"                                                                      << std::endl;
+        stream << ""                                                                              << std::endl;
+        stream << "  -h, --help                    display this help and exit"                    << std::endl;
+        stream << "  --suite=NAME                  throughput (default), pathological or compile" << std::endl;
+        stream << "  --corpus=NAME|FILE            log, text, utf8, pathological, patterns or a file" << std::endl;
+        stream << "  --pattern=PATTERN             pattern to benchmark (repeatable)"             << std::endl;
+        stream << "  --rounds=COUNT                number of measured rounds (default: 3)"        << std::endl;
+        stream << "  --budget=SECONDS              stop scaling a case past this time per run"    << std::endl;
+        stream << "  --json=FILE                   write the results as JSON"                     << std::endl;
+        stream << "  --ignore-case                 compile the patterns case-insensitive"         << std::endl;
+        stream << "  --utf8                        compile the patterns in UTF-8 mode"            << std::endl;
+        stream << "  --multiline                   scan the corpus as one buffer of lines"        << std::endl;
+        stream << "  --is-match                    match with is_match() instead of execute()"    << std::endl;
+        stream << "  --perf                        read hardware counters (Linux only)"           << std::endl;
+        stream << ""                                                                              << std::endl;
+    };
+
+    return do_help(std::cout);
+}
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    const ArgList args(argv, argv + argc);
+
+    try {
+        if(Benchmark::init(args) != false) {
+            Benchmark::main(args);
+        }
+        else {
+            Benchmark::help(args);
+        }
+    }
+    catch(const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch(...) {
+        std::cerr << "error!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+/*
+ * benchmark.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Benchmark_h__
+#define __Benchmark_h__
+
+#include "perfcounters.h"
+
+// ---------------------------------------------------------------------------
+// type aliases
+// ---------------------------------------------------------------------------
+
+using ArgList = std::vector<std::string>;
+
+// ---------------------------------------------------------------------------
+// BenchResult
+// ---------------------------------------------------------------------------
+
+struct BenchResult
+{
+    std::string suite;
+    std::string engine;
+    std::string corpus;
+    std::string pattern;
+    uint64_t    scale;
+    uint64_t    bytes;
+    uint64_t    executions;
+    uint64_t    matches;
+    uint64_t    allocations;
+    double      compile_ns;
+    double      seconds;
+    double      p50_ns;
+    double      p99_ns;
+    double      p999_ns;
+    double      growth;
+    bool        exceeded;
+    bool        has_counters;
+    uint64_t    counters[PerfCounters::CNT_COUNT];
+};
+
+using BenchResults = std::vector<BenchResult>;
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+struct Benchmark
+{
+    static std::string arg0;
+    static std::string suite;
+    static std::string json;
+    static ArgList     corpora;
+    static ArgList     patterns;
+    static uint32_t    rounds;
+    static double      budget;
+    static uint32_t    flags;
+    static bool        earliest;
+    static bool        perf;
+
+    static auto init(const ArgList& args) -> bool;
+
+    static auto main(const ArgList& args) -> void;
+
+    static auto help(const ArgList& args) -> void;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Benchmark_h__ */
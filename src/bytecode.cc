@@ -30,6 +30,7 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 #include <stdexcept>
 #include "bytecode.h"
 
@@ -39,12 +40,262 @@
 
 ByteCode::ByteCode()
     : _bytecode()
+    , _min_length(0)
+    , _max_length(UNBOUNDED)
+    , _repetitions(0)
+    , _anchored_begin(false)
+    , _anchored_end(false)
 {
 }
 
+auto ByteCode::opcode_name(const uint8_t opcode) -> const char*
+{
+    switch(opcode) {
+        case OP_NOP:
+            return "nop";
+        case OP_STX:
+            return "stx";
+        case OP_ETX:
+            return "etx";
+        case OP_ANY:
+            return "any";
+        case OP_CHR:
+            return "chr";
+        case OP_REP:
+            return "rep";
+        case OP_ERR:
+            return "err";
+        case OP_RET:
+            return "ret";
+        case OP_CH2:
+            return "ch2";
+        case OP_SEQ:
+            return "seq";
+        case OP_UTF:
+            return "utf";
+        case OP_ALT:
+            return "alt";
+        case OP_JMP:
+            return "jmp";
+        case OP_JTB:
+            return "jtb";
+        case OP_POS:
+            return "pos";
+        case OP_LZY:
+            return "lzy";
+        case OP_BOL:
+            return "bol";
+        case OP_EOL:
+            return "eol";
+        default:
+            break;
+    }
+    return "???";
+}
+
 auto ByteCode::clear() -> void
 {
-    container_type().swap(_bytecode);
+    _bytecode.clear();
+    _min_length     = 0;
+    _max_length     = UNBOUNDED;
+    _repetitions    = 0;
+    _anchored_begin = false;
+    _anchored_end   = false;
+}
+
+auto ByteCode::assign(const ByteCode& bytecode) -> void
+{
+    _bytecode       = bytecode._bytecode;
+    _min_length     = bytecode._min_length;
+    _max_length     = bytecode._max_length;
+    _repetitions    = bytecode._repetitions;
+    _anchored_begin = bytecode._anchored_begin;
+    _anchored_end   = bytecode._anchored_end;
+}
+
+auto ByteCode::reserve(const size_type size) -> void
+{
+    _bytecode.reserve(size);
+}
+
+auto ByteCode::analyze() -> void
+{
+    struct Reach
+    {
+        uint64_t min;     // shortest length consumed to get here
+        uint64_t max;     // longest length consumed to get here
+        bool     reached; // at least one path gets here
+        bool     begin;   // every path went through a start of text
+        bool     end;     // every path went through an end of text
+    };
+
+    std::vector<Reach> reach(_bytecode.size() + 1, Reach { UNBOUNDED, 0, false, true, true });
+    ByteCodeIterator   bytecode(*this);
+    Reach              result { UNBOUNDED, 0, false, true, true };
+    uint32_t           repetitions = 0;
+
+    auto add = [](const uint64_t length1, const uint64_t length2) -> uint64_t
+    {
+        if((length1 == UNBOUNDED) || (length2 == UNBOUNDED)) {
+            return UNBOUNDED;
+        }
+        return length1 + length2;
+    };
+
+    auto multiply = [](const uint32_t count, const uint64_t length) -> uint64_t
+    {
+        if((count == 0) || (length == 0)) {
+            return 0;
+        }
+        if((count == 0xffffffff) || (length == UNBOUNDED)) {
+            return UNBOUNDED;
+        }
+        return count * length;
+    };
+
+    auto merge = [](Reach& into, const Reach& from) -> void
+    {
+        into.min     = std::min(into.min, from.min);
+        into.max     = std::max(into.max, from.max);
+        into.reached = true;
+        into.begin   = (into.begin && from.begin);
+        into.end     = (into.end && from.end);
+    };
+
+    auto atom_length = [&](const uint8_t opcode, uint64_t& min, uint64_t& max) -> bool
+    {
+        switch(opcode) {
+            case OP_ANY:
+                min = max = 1;
+                return true;
+            case OP_CHR:
+                bytecode.advance(1);
+                min = max = 1;
+                return true;
+            case OP_CH2:
+                bytecode.advance(2);
+                min = max = 1;
+                return true;
+            case OP_SEQ:
+                min = max = bytecode.next_byte();
+                bytecode.advance(min);
+                return true;
+            case OP_UTF:
+                min = 1;
+                max = 4;
+                return true;
+            default:
+                break;
+        }
+        return false;
+    };
+
+    /* the jumps only go forward, so one pass in program order reaches every instruction with all its paths */
+    reach[0] = Reach { 0, 0, true, false, false };
+    while(bytecode) {
+        const Reach   current(reach[bytecode.offset()]);
+        const uint8_t opcode = bytecode.next_byte();
+        Reach         next(current);
+        bool          fallthrough = true;
+        switch(opcode) {
+            case OP_NOP:
+            case OP_BOL:
+            case OP_EOL:
+                break;
+            case OP_STX:
+                next.begin = true;
+                break;
+            case OP_ETX:
+                next.end = true;
+                break;
+            case OP_ANY:
+            case OP_CHR:
+            case OP_CH2:
+            case OP_SEQ:
+            case OP_UTF:
+                {
+                    uint64_t min = 0;
+                    uint64_t max = 0;
+                    static_cast<void>(atom_length(opcode, min, max));
+                    next.min = add(next.min, min);
+                    next.max = add(next.max, max);
+                }
+                break;
+            case OP_REP:
+            case OP_POS:
+            case OP_LZY:
+                {
+                    const uint32_t repeat_min = bytecode.next_long();
+                    const uint32_t repeat_max = bytecode.next_long();
+                    const uint8_t  atom       = bytecode.next_byte();
+                    uint64_t       min        = 0;
+                    uint64_t       max        = 0;
+                    if(atom_length(atom, min, max) == false) {
+                        return;
+                    }
+                    next.min = add(next.min, multiply(repeat_min, min));
+                    next.max = add(next.max, multiply(repeat_max, max));
+                    /* any repetition of variable count may give back, an unbounded one of any character up to the whole input, it counts twice */
+                    if((opcode != OP_POS) && (repeat_max != repeat_min)) {
+                        repetitions += ((((atom == OP_ANY) || (atom == OP_UTF)) && (repeat_max == 0xffffffff)) ? 2 : 1);
+                    }
+                }
+                break;
+            case OP_ALT:
+                {
+                    const uint32_t target = bytecode.next_long();
+                    if((current.reached != false) && (target < reach.size())) {
+                        merge(reach[target], current);
+                    }
+                }
+                break;
+            case OP_JMP:
+                {
+                    const uint32_t target = bytecode.next_long();
+                    if((current.reached != false) && (target < reach.size())) {
+                        merge(reach[target], current);
+                    }
+                    fallthrough = false;
+                }
+                break;
+            case OP_JTB:
+                {
+                    const uint8_t lower = bytecode.next_byte();
+                    const uint8_t upper = bytecode.next_byte();
+                    next.min = add(next.min, 1);
+                    next.max = add(next.max, 1);
+                    for(uint32_t byte = lower; byte <= upper; ++byte) {
+                        const uint32_t target = bytecode.next_long();
+                        if((current.reached != false) && (target != 0) && (target < reach.size())) {
+                            merge(reach[target], next);
+                        }
+                    }
+                    fallthrough = false;
+                }
+                break;
+            case OP_RET:
+                if(current.reached != false) {
+                    merge(result, current);
+                }
+                fallthrough = false;
+                break;
+            case OP_ERR:
+                fallthrough = false;
+                break;
+            default:
+                return;
+        }
+        if((fallthrough != false) && (current.reached != false)) {
+            merge(reach[bytecode.offset()], next);
+        }
+    }
+    if(result.reached != false) {
+        _min_length     = result.min;
+        _max_length     = result.max;
+        _anchored_begin = result.begin;
+        _anchored_end   = result.end;
+        _repetitions    = repetitions;
+    }
 }
 
 auto ByteCode::emit_byte(const uint8_t value) -> void
@@ -81,6 +332,16 @@ auto ByteCode::emit_etx() -> void
     emit_byte(OP_ETX);
 }
 
+auto ByteCode::emit_bol() -> void
+{
+    emit_byte(OP_BOL);
+}
+
+auto ByteCode::emit_eol() -> void
+{
+    emit_byte(OP_EOL);
+}
+
 auto ByteCode::emit_any() -> void
 {
     emit_byte(OP_ANY);
@@ -92,6 +353,27 @@ auto ByteCode::emit_chr(const uint8_t character) -> void
     emit_byte(character);
 }
 
+auto ByteCode::emit_ch2(const uint8_t character1, const uint8_t character2) -> void
+{
+    emit_byte(OP_CH2);
+    emit_byte(character1);
+    emit_byte(character2);
+}
+
+auto ByteCode::emit_seq(const uint8_t* characters, const uint8_t count) -> void
+{
+    emit_byte(OP_SEQ);
+    emit_byte(count);
+    for(uint8_t index = 0; index < count; ++index) {
+        emit_byte(characters[index]);
+    }
+}
+
+auto ByteCode::emit_utf() -> void
+{
+    emit_byte(OP_UTF);
+}
+
 auto ByteCode::emit_rep(const uint32_t min, const uint32_t max) -> void
 {
     emit_byte(OP_REP);
@@ -99,6 +381,50 @@ auto ByteCode::emit_rep(const uint32_t min, const uint32_t max) -> void
     emit_long(max);
 }
 
+auto ByteCode::emit_pos(const uint32_t min, const uint32_t max) -> void
+{
+    emit_byte(OP_POS);
+    emit_long(min);
+    emit_long(max);
+}
+
+auto ByteCode::emit_lzy(const uint32_t min, const uint32_t max) -> void
+{
+    emit_byte(OP_LZY);
+    emit_long(min);
+    emit_long(max);
+}
+
+auto ByteCode::emit_alt(const uint32_t target) -> void
+{
+    emit_byte(OP_ALT);
+    emit_long(target);
+}
+
+auto ByteCode::emit_jmp(const uint32_t target) -> void
+{
+    emit_byte(OP_JMP);
+    emit_long(target);
+}
+
+auto ByteCode::emit_jtb(const uint8_t lower, const uint8_t upper) -> void
+{
+    emit_byte(OP_JTB);
+    emit_byte(lower);
+    emit_byte(upper);
+    for(uint32_t index = lower; index <= upper; ++index) {
+        emit_long(0);
+    }
+}
+
+auto ByteCode::patch_long(const size_type offset, const uint32_t value) -> void
+{
+    _bytecode[offset + 0] = static_cast<uint8_t>((value >> 24) & 0xff);
+    _bytecode[offset + 1] = static_cast<uint8_t>((value >> 16) & 0xff);
+    _bytecode[offset + 2] = static_cast<uint8_t>((value >>  8) & 0xff);
+    _bytecode[offset + 3] = static_cast<uint8_t>((value >>  0) & 0xff);
+}
+
 auto ByteCode::emit_err() -> void
 {
     emit_byte(OP_ERR);
@@ -55,6 +55,20 @@ public: // public interface
     static constexpr uint8_t OP_REP = 0x05; // repeat
     static constexpr uint8_t OP_ERR = 0x06; // error
     static constexpr uint8_t OP_RET = 0x07; // return
+    static constexpr uint8_t OP_CH2 = 0x08; // one of two specific characters
+    static constexpr uint8_t OP_SEQ = 0x09; // sequence of characters
+    static constexpr uint8_t OP_UTF = 0x0a; // any utf-8 character
+    static constexpr uint8_t OP_ALT = 0x0b; // split, the alternative is at the target
+    static constexpr uint8_t OP_JMP = 0x0c; // jump to the target
+    static constexpr uint8_t OP_JTB = 0x0d; // jump table indexed by the next character
+    static constexpr uint8_t OP_POS = 0x0e; // possessive repeat, never gives back
+    static constexpr uint8_t OP_LZY = 0x0f; // lazy repeat, shortest run first
+    static constexpr uint8_t OP_BOL = 0x10; // start of line
+    static constexpr uint8_t OP_EOL = 0x11; // end of line
+
+    static constexpr uint64_t UNBOUNDED = ~static_cast<uint64_t>(0);
+
+    static auto opcode_name(const uint8_t opcode) -> const char*;
 
     auto begin() const -> const_iterator
     {
@@ -66,8 +80,59 @@ public: // public interface
         return _bytecode.end();
     }
 
+    auto data() const -> const value_type*
+    {
+        return _bytecode.data();
+    }
+
+    auto size() const -> size_type
+    {
+        return _bytecode.size();
+    }
+
+    auto capacity() const -> size_type
+    {
+        return _bytecode.capacity();
+    }
+
+    auto min_length() const -> uint64_t
+    {
+        return _min_length;
+    }
+
+    auto max_length() const -> uint64_t
+    {
+        return _max_length;
+    }
+
+    auto anchored_begin() const -> bool
+    {
+        return _anchored_begin;
+    }
+
+    auto anchored_end() const -> bool
+    {
+        return _anchored_end;
+    }
+
+    auto repetitions() const -> uint32_t
+    {
+        return _repetitions;
+    }
+
+    auto rejects(const size_t size) const -> bool
+    {
+        return (size < _min_length) || ((_anchored_begin != false) && (_anchored_end != false) && (size > _max_length));
+    }
+
     auto clear() -> void;
 
+    auto assign(const ByteCode& bytecode) -> void;
+
+    auto reserve(const size_type size) -> void;
+
+    auto analyze() -> void;
+
     auto emit_byte(const uint8_t value) -> void;
 
     auto emit_word(const uint16_t value) -> void;
@@ -80,18 +145,45 @@ public: // public interface
 
     auto emit_etx() -> void;
 
+    auto emit_bol() -> void;
+
+    auto emit_eol() -> void;
+
     auto emit_any() -> void;
 
     auto emit_chr(const uint8_t character) -> void;
 
+    auto emit_ch2(const uint8_t character1, const uint8_t character2) -> void;
+
+    auto emit_seq(const uint8_t* characters, const uint8_t count) -> void;
+
+    auto emit_utf() -> void;
+
     auto emit_rep(const uint32_t min, const uint32_t max) -> void;
 
+    auto emit_pos(const uint32_t min, const uint32_t max) -> void;
+
+    auto emit_lzy(const uint32_t min, const uint32_t max) -> void;
+
+    auto emit_alt(const uint32_t target) -> void;
+
+    auto emit_jmp(const uint32_t target) -> void;
+
+    auto emit_jtb(const uint8_t lower, const uint8_t upper) -> void;
+
+    auto patch_long(const size_type offset, const uint32_t value) -> void;
+
     auto emit_err() -> void;
 
     auto emit_ret() -> void;
 
 protected: // protected data
     container_type _bytecode;
+    uint64_t       _min_length;
+    uint64_t       _max_length;
+    uint32_t       _repetitions;
+    bool           _anchored_begin;
+    bool           _anchored_end;
 };
 
 // ---------------------------------------------------------------------------
@@ -102,9 +194,9 @@ class ByteCodeIterator
 {
 public: // public interface
     ByteCodeIterator(const ByteCode& bytecode)
-        : _begin(bytecode.begin())
-        , _curr(bytecode.begin())
-        , _end(bytecode.end())
+        : _begin(bytecode.data())
+        , _curr(bytecode.data())
+        , _end(bytecode.data() + bytecode.size())
     {
     }
 
@@ -118,6 +210,36 @@ public: // public interface
         _curr = _end;
     }
 
+    auto curr() const -> const uint8_t*
+    {
+        return _curr;
+    }
+
+    auto offset() const -> uint32_t
+    {
+        return static_cast<uint32_t>(_curr - _begin);
+    }
+
+    auto jump(const uint32_t offset) -> void
+    {
+        if(static_cast<size_t>(_end - _begin) < offset) {
+            _curr = _end;
+        }
+        else {
+            _curr = _begin + offset;
+        }
+    }
+
+    auto advance(const size_t distance) -> void
+    {
+        if(static_cast<size_t>(_end - _curr) < distance) {
+            _curr = _end;
+        }
+        else {
+            _curr += distance;
+        }
+    }
+
     auto next_byte() -> uint8_t
     {
         uint8_t value = 0;
@@ -155,9 +277,9 @@ public: // public interface
     }
 
 private: // private data
-    ByteCode::const_iterator _begin;
-    ByteCode::const_iterator _curr;
-    ByteCode::const_iterator _end;
+    const uint8_t* _begin;
+    const uint8_t* _curr;
+    const uint8_t* _end;
 };
 
 // ---------------------------------------------------------------------------
@@ -167,24 +289,29 @@ private: // private data
 class StringIterator
 {
 public: // public interface
+    StringIterator(const char* data, const size_t size)
+        : _begin(data)
+        , _curr(data)
+        , _end(data + size)
+    {
+    }
+
     StringIterator(const std::string& string)
-        : _begin(string.begin())
-        , _curr(string.begin())
-        , _end(string.end())
+        : StringIterator(string.data(), string.size())
     {
     }
 
-    auto begin() const -> std::string::const_iterator
+    auto begin() const -> const char*
     {
         return _begin;
     }
 
-    auto curr() const -> std::string::const_iterator
+    auto curr() const -> const char*
     {
         return _curr;
     }
 
-    auto end() const -> std::string::const_iterator
+    auto end() const -> const char*
     {
         return _end;
     }
@@ -199,25 +326,48 @@ public: // public interface
         return _curr == _end;
     }
 
+    auto at_line_begin() const -> bool
+    {
+        return (_curr == _begin) || (_curr[-1] == '\n');
+    }
+
+    auto at_line_end() const -> bool
+    {
+        return (_curr == _end) || (_curr[0] == '\n');
+    }
+
     auto advance(const size_t distance) -> void
     {
-        if((_curr += distance) > _end) {
+        if(static_cast<size_t>(_end - _curr) < distance) {
             _curr = _end;
         }
+        else {
+            _curr += distance;
+        }
     }
 
-    auto peek() -> std::string::value_type
+    auto retreat(const size_t distance) -> void
+    {
+        if(static_cast<size_t>(_curr - _begin) < distance) {
+            _curr = _begin;
+        }
+        else {
+            _curr -= distance;
+        }
+    }
+
+    auto peek() -> char
     {
         if(_curr == _end) {
-            return std::string::value_type();
+            return '\0';
         }
         return *_curr;
     }
 
-    auto next() -> std::string::value_type
+    auto next() -> char
     {
         if(_curr == _end) {
-            return std::string::value_type();
+            return '\0';
         }
         return *_curr++;
     }
@@ -228,9 +378,29 @@ public: // public interface
     }
 
 private: // private data
-    std::string::const_iterator _begin;
-    std::string::const_iterator _curr;
-    std::string::const_iterator _end;
+    const char* _begin;
+    const char* _curr;
+    const char* _end;
+};
+
+// ---------------------------------------------------------------------------
+// Input
+// ---------------------------------------------------------------------------
+
+struct Input
+{
+    const char* data;
+    size_t      size;
+};
+
+// ---------------------------------------------------------------------------
+// Line
+// ---------------------------------------------------------------------------
+
+struct Line
+{
+    size_t offset;
+    size_t size;
 };
 
 // ---------------------------------------------------------------------------
@@ -33,53 +33,173 @@
 #include <stdexcept>
 #include "compiler.h"
 
+// ---------------------------------------------------------------------------
+// CompileError
+// ---------------------------------------------------------------------------
+
+auto CompileError::message(const uint32_t code) -> const char*
+{
+    switch(code) {
+        case ERR_NONE:
+            return "no error";
+        case ERR_UNEXPECTED_QUANTIFIER:
+            return "unexpected quantifier";
+        case ERR_UNEXPECTED_CHARACTER:
+            return "unexpected character";
+        case ERR_UNEXPECTED_END:
+            return "unexpected end of pattern";
+        case ERR_INVALID_ESCAPE:
+            return "invalid escape sequence";
+        case ERR_INVALID_UTF8:
+            return "invalid utf-8 sequence";
+        case ERR_INVALID_REPETITION:
+            return "invalid repetition bounds";
+        default:
+            break;
+    }
+    return "unknown error";
+}
+
+// ---------------------------------------------------------------------------
+// LiteralTrie
+// ---------------------------------------------------------------------------
+
+auto LiteralTrie::clear() -> void
+{
+    nodes.clear();
+    nodes.push_back(Node { 0, 0, 0, false });
+}
+
+auto LiteralTrie::insert(const std::string& literal) -> void
+{
+    uint32_t node = 0;
+
+    for(const char character : literal) {
+        const uint8_t byte  = static_cast<uint8_t>(character);
+        uint32_t      child = nodes[node].child;
+        while((child != 0) && (nodes[child].byte != byte)) {
+            child = nodes[child].sibling;
+        }
+        if(child == 0) {
+            child = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node { 0, nodes[node].child, byte, false });
+            nodes[node].child = child;
+        }
+        node = child;
+    }
+    nodes[node].final = true;
+}
+
+// ---------------------------------------------------------------------------
+// Literal
+// ---------------------------------------------------------------------------
+
+auto Literal::clear() -> void
+{
+    bytes.clear();
+    pure  = false;
+    begin = false;
+    end   = false;
+}
+
+auto Literal::search(const char* data, const size_t size, size_t& position) const -> bool
+{
+    const size_t length = bytes.size();
+
+    if(length > size) {
+        return false;
+    }
+    /* an anchored literal can only be at one place */
+    if(begin != false) {
+        position = 0;
+        return ((end == false) || (length == size)) && (::memcmp(data, bytes.data(), length) == 0);
+    }
+    if(end != false) {
+        position = size - length;
+        return ::memcmp(data + position, bytes.data(), length) == 0;
+    }
+    position = Scan::find_literal(data, size, bytes.data(), length);
+    return (position + length) <= size;
+}
+
 // ---------------------------------------------------------------------------
 // Compiler
 // ---------------------------------------------------------------------------
 
-Compiler::Compiler(ByteCode& bytecode, OStream& ostream, const uint32_t loglevel)
-    : _ostream(std::cout)
+template <typename Trace>
+Compiler<Trace>::Compiler(ByteCode& bytecode, OStream& ostream, const uint32_t loglevel)
+    : _ostream(ostream)
     , _loglevel(loglevel)
     , _bytecode(bytecode)
+    , _pattern(nullptr)
+    , _flags(CompileFlags::FLAG_NONE)
+    , _error { CompileError::ERR_NONE, 0 }
+    , _literal()
+    , _trie()
+    , _branch()
+    , _fixups()
+{
+    _literal.clear();
+}
+
+template <typename Trace>
+auto Compiler<Trace>::compile(const std::string& string) -> bool
+{
+    return compile(string.data(), string.size());
+}
+
+template <typename Trace>
+auto Compiler<Trace>::compile(const char* data, const size_t size) -> bool
 {
+    return compile(data, size, CompileFlags::FLAG_NONE);
 }
 
-auto Compiler::compile(const std::string& string) -> bool
+template <typename Trace>
+auto Compiler<Trace>::compile(const char* data, const size_t size, const uint32_t flags) -> bool
 {
-    StringIterator pattern(string);
+    StringIterator pattern(data, size);
 
-    try {
-        begin(string);
-        expect_expression(pattern);
+    begin(data, size, flags);
+    if(expect_alternation(pattern) != false) {
         return success();
     }
-    catch(const std::exception& e) {
-        if(_loglevel >= LogLevel::LOG_ERROR) {
-            _ostream << "🔴" << ' ' << e.what() << std::endl;
-        }
+    if(_loglevel >= LogLevel::LOG_ERROR) {
+        _ostream << "🔴" << ' ' << CompileError::message(_error.code) << ' ' << "at offset" << ' ' << _error.offset << std::endl;
     }
     return failure();
 }
 
-auto Compiler::begin(const std::string& string) -> void
+template <typename Trace>
+auto Compiler<Trace>::begin(const char* data, const size_t size, const uint32_t flags) -> void
 {
     if(_loglevel >= LogLevel::LOG_PRINT) {
-        _ostream << "🔵" << ' ' << "compiling" << '<' << string << '>' << std::endl;
+        _ostream << "🔵" << ' ' << "compiling" << '<';
+        _ostream.write(data, size);
+        _ostream << '>' << std::endl;
     }
+    _pattern = data;
+    _flags   = flags;
+    _error   = CompileError { CompileError::ERR_NONE, 0 };
+    _literal.clear();
     clear();
+    reserve(size);
     emit_nop();
 }
 
-auto Compiler::success() -> bool
+template <typename Trace>
+auto Compiler<Trace>::success() -> bool
 {
     emit_ret();
+    analyze_literal();
+    analyze();
     if(_loglevel >= LogLevel::LOG_ALERT) {
         _ostream << "🟢" << ' ' << "the regular expression has been compiled" << std::endl;
     }
     return true;
 }
 
-auto Compiler::failure() -> bool
+template <typename Trace>
+auto Compiler<Trace>::failure() -> bool
 {
     emit_err();
     if(_loglevel >= LogLevel::LOG_ERROR) {
@@ -88,215 +208,727 @@ auto Compiler::failure() -> bool
     return false;
 }
 
-auto Compiler::clear() -> void
+template <typename Trace>
+auto Compiler<Trace>::analyze_literal() -> void
+{
+    ByteCodeIterator bytecode(_bytecode);
+    Literal          literal;
+
+    /* a literal program is a run of characters, optionally anchored to the text */
+    literal.clear();
+    if(bytecode.next_byte() != ByteCode::OP_NOP) {
+        return;
+    }
+    while(bytecode) {
+        const uint32_t offset = bytecode.offset();
+        const uint8_t  opcode = bytecode.next_byte();
+        switch(opcode) {
+            case ByteCode::OP_STX:
+                if(offset != 1) {
+                    return;
+                }
+                literal.begin = true;
+                break;
+            case ByteCode::OP_CHR:
+                if(literal.end != false) {
+                    return;
+                }
+                literal.bytes.push_back(bytecode.next_byte());
+                break;
+            case ByteCode::OP_SEQ:
+                if(literal.end != false) {
+                    return;
+                }
+                for(uint8_t count = bytecode.next_byte(); count != 0; --count) {
+                    literal.bytes.push_back(bytecode.next_byte());
+                }
+                break;
+            case ByteCode::OP_ETX:
+                literal.end = true;
+                break;
+            case ByteCode::OP_RET:
+                literal.pure = (bytecode.offset() == _bytecode.size());
+                if(literal.pure != false) {
+                    _literal = literal;
+                }
+                return;
+            default:
+                return;
+        }
+    }
+}
+
+template <typename Trace>
+auto Compiler<Trace>::clear() -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "code:clear" << std::endl;
     }
     _bytecode.clear();
 }
 
-auto Compiler::emit_nop() -> void
+template <typename Trace>
+auto Compiler<Trace>::reserve(const size_t size) -> void
+{
+    /* a hint sized for the common case, "x*" (rep + chr) for two pattern bytes plus nop and ret, the bytecode still grows past it for case-folded characters and jump tables */
+    _bytecode.reserve(size * 11 / 2 + 2);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::analyze() -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    _bytecode.analyze();
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "code:length" << ' ' << '<' << _bytecode.min_length() << ',';
+        if(_bytecode.max_length() == ByteCode::UNBOUNDED) {
+            _ostream << "inf";
+        }
+        else {
+            _ostream << _bytecode.max_length();
+        }
+        _ostream << '>' << std::endl;
+    }
+}
+
+template <typename Trace>
+auto Compiler<Trace>::error(const uint32_t code, const StringIterator& pattern) -> bool
+{
+    _error = CompileError { code, static_cast<size_t>(pattern.curr() - _pattern) };
+    return false;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_nop() -> void
+{
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:nop" << std::endl;
     }
     _bytecode.emit_nop();
 }
 
-auto Compiler::emit_stx() -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_stx() -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:stx" << std::endl;
     }
     _bytecode.emit_stx();
 }
 
-auto Compiler::emit_etx() -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_etx() -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:etx" << std::endl;
     }
     _bytecode.emit_etx();
 }
 
-auto Compiler::emit_any() -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_bol() -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:bol" << std::endl;
+    }
+    _bytecode.emit_bol();
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_eol() -> void
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:eol" << std::endl;
+    }
+    _bytecode.emit_eol();
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_any() -> void
+{
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:any" << std::endl;
     }
     _bytecode.emit_any();
 }
 
-auto Compiler::emit_chr(const uint8_t character) -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_chr(const uint8_t character) -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:chr" << ' ' << '<' << character << '>' << std::endl;
     }
     _bytecode.emit_chr(character);
 }
 
-auto Compiler::emit_rep(const uint32_t min, const uint32_t max) -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_ch2(const uint8_t character1, const uint8_t character2) -> void
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:ch2" << ' ' << '<' << character1 << ',' << character2 << '>' << std::endl;
+    }
+    _bytecode.emit_ch2(character1, character2);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_literal(const uint8_t character) -> void
+{
+    if((_flags & CompileFlags::FLAG_ICASE) != 0) {
+        if((character >= 'a') && (character <= 'z')) {
+            return emit_ch2(character, character - 'a' + 'A');
+        }
+        if((character >= 'A') && (character <= 'Z')) {
+            return emit_ch2(character - 'A' + 'a', character);
+        }
+    }
+    return emit_chr(character);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_seq(const uint8_t* characters, const uint8_t count) -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:seq" << ' ' << '<';
+        _ostream.write(reinterpret_cast<const char*>(characters), count);
+        _ostream << '>' << std::endl;
+    }
+    _bytecode.emit_seq(characters, count);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_utf() -> void
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:utf" << std::endl;
+    }
+    _bytecode.emit_utf();
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_rep(const uint32_t min, const uint32_t max) -> void
+{
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:rep" << ' ' << '<' << min << ',' << max << '>' << std::endl;
     }
     _bytecode.emit_rep(min, max);
 }
 
-auto Compiler::emit_err() -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_pos(const uint32_t min, const uint32_t max) -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:pos" << ' ' << '<' << min << ',' << max << '>' << std::endl;
+    }
+    _bytecode.emit_pos(min, max);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_lzy(const uint32_t min, const uint32_t max) -> void
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:lzy" << ' ' << '<' << min << ',' << max << '>' << std::endl;
+    }
+    _bytecode.emit_lzy(min, max);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_alt(const uint32_t target) -> size_t
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:alt" << ' ' << '<' << target << '>' << std::endl;
+    }
+    _bytecode.emit_alt(target);
+
+    return _bytecode.size() - 4;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_jmp(const uint32_t target) -> size_t
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:jmp" << ' ' << '<' << target << '>' << std::endl;
+    }
+    _bytecode.emit_jmp(target);
+
+    return _bytecode.size() - 4;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_jtb(const uint8_t lower, const uint8_t upper) -> size_t
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "emit:jtb" << ' ' << '<' << lower << ',' << upper << '>' << std::endl;
+    }
+    _bytecode.emit_jtb(lower, upper);
+
+    return _bytecode.size() - ((upper - lower + 1) * 4);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_run(const std::string& characters) -> void
+{
+    if((_flags & CompileFlags::FLAG_ICASE) != 0) {
+        for(const char character : characters) {
+            emit_literal(character);
+        }
+        return;
+    }
+    for(size_t offset = 0; offset < characters.size(); offset += 255) {
+        const size_t count = std::min(characters.size() - offset, static_cast<size_t>(255));
+        if(count == 1) {
+            emit_chr(characters[offset]);
+        }
+        else {
+            emit_seq(reinterpret_cast<const uint8_t*>(characters.data() + offset), static_cast<uint8_t>(count));
+        }
+    }
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_trie(const LiteralTrie& trie, uint32_t node, std::vector<size_t>& fixups) -> void
+{
+    const bool  icase = ((_flags & CompileFlags::FLAG_ICASE) != 0);
+    std::string run;
+
+    auto fold = [&](const uint8_t byte) -> uint8_t
+    {
+        if((icase != false) && (byte >= 'a') && (byte <= 'z')) {
+            return byte - 'a' + 'A';
+        }
+        return byte;
+    };
+
+    /* a chain of single children is matched as one run */
+    while((trie.nodes[node].final == false) && (trie.nodes[trie.nodes[node].child].sibling == 0)) {
+        node = trie.nodes[node].child;
+        run += static_cast<char>(trie.nodes[node].byte);
+    }
+    emit_run(run);
+    /* the match is a boolean, so a branch that ends here makes the longer ones redundant */
+    if(trie.nodes[node].final != false) {
+        fixups.push_back(emit_jmp(0));
+        return;
+    }
+    uint8_t lower = 0xff;
+    uint8_t upper = 0x00;
+    for(uint32_t child = trie.nodes[node].child; child != 0; child = trie.nodes[child].sibling) {
+        lower = std::min(lower, fold(trie.nodes[child].byte));
+        upper = std::max(upper, trie.nodes[child].byte);
+    }
+    const size_t table = emit_jtb(lower, upper);
+    for(uint32_t child = trie.nodes[node].child; child != 0; child = trie.nodes[child].sibling) {
+        const uint8_t byte = trie.nodes[child].byte;
+        _bytecode.patch_long(table + ((byte - lower) * 4), _bytecode.size());
+        if(fold(byte) != byte) {
+            _bytecode.patch_long(table + ((fold(byte) - lower) * 4), _bytecode.size());
+        }
+        emit_trie(trie, child, fixups);
+    }
+}
+
+template <typename Trace>
+auto Compiler<Trace>::patch_target(const size_t offset) -> void
+{
+    if(Trace::enabled) {
+        _ostream << "🟣" << ' ' << "code:patch" << ' ' << '<' << offset << ',' << _bytecode.size() << '>' << std::endl;
+    }
+    _bytecode.patch_long(offset, _bytecode.size());
+}
+
+template <typename Trace>
+auto Compiler<Trace>::emit_err() -> void
+{
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:err" << std::endl;
     }
     _bytecode.emit_err();
 }
 
-auto Compiler::emit_ret() -> void
+template <typename Trace>
+auto Compiler<Trace>::emit_ret() -> void
 {
-    if(_loglevel >= LogLevel::LOG_DEBUG) {
+    if(Trace::enabled) {
         _ostream << "🟣" << ' ' << "emit:ret" << std::endl;
     }
     _bytecode.emit_ret();
 }
 
-auto Compiler::expect_expression(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::expect_alternation(StringIterator& pattern) -> bool
 {
-    const auto prev = pattern.curr();
+    StringIterator start(pattern);
+    StringIterator branch(pattern);
 
-    if(pattern) {
-        do {
-            const char character = pattern.peek();
-            switch(character) {
-                case '?':
-                    throw std::runtime_error("unexpected <?> quantifier");
-                case '*':
-                    throw std::runtime_error("unexpected <*> quantifier");
-                case '+':
-                    throw std::runtime_error("unexpected <+> quantifier");
-                case '^':
-                    pattern.advance(expect_stx(pattern));
-                    break;
-                case '$':
-                    pattern.advance(expect_etx(pattern));
-                    break;
-                case '.':
-                    pattern.advance(expect_any(pattern));
-                    break;
-                case '\\':
-                    pattern.advance(expect_esc(pattern));
-                    break;
-                default:
-                    pattern.advance(expect_chr(pattern));
-                    break;
+    if(accept_branch(pattern, branch) == false) {
+        return expect_expression(branch);
+    }
+    pattern = start;
+    if(accept_literals(pattern) != false) {
+        return true;
+    }
+    _fixups.clear();
+    for(bool more = true; more != false;) {
+        more = accept_branch(pattern, branch);
+        if(more != false) {
+            const size_t alternative = emit_alt(0);
+            if(expect_expression(branch) == false) {
+                return false;
             }
-        } while(pattern);
+            _fixups.push_back(emit_jmp(0));
+            patch_target(alternative);
+        }
+        else if(expect_expression(branch) == false) {
+            return false;
+        }
+    }
+    for(const size_t fixup : _fixups) {
+        patch_target(fixup);
+    }
+    return true;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::accept_branch(StringIterator& pattern, StringIterator& branch) -> bool
+{
+    const char* first = pattern.curr();
+
+    while(pattern) {
+        const char character = pattern.next();
+        if(character == '\\') {
+            static_cast<void>(pattern.next());
+        }
+        else if(character == '|') {
+            branch = StringIterator(first, pattern.curr() - first - 1);
+            return true;
+        }
     }
-    return pattern.curr() - prev;
-};
+    branch = StringIterator(first, pattern.curr() - first);
+    return false;
+}
 
-auto Compiler::accept_quantifier(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::accept_literal(StringIterator branch, std::string& literal) -> bool
 {
-    const auto prev = pattern.curr();
+    literal.clear();
+    while(branch) {
+        char character = branch.next();
+        switch(character) {
+            case '^':
+            case '$':
+            case '.':
+            case '?':
+            case '*':
+            case '+':
+            case '{':
+                return false;
+            case '\\':
+                if(!branch) {
+                    return false;
+                }
+                character = branch.next();
+                switch(character) {
+                    case 'a': character = '\a'; break;
+                    case 'b': character = '\b'; break;
+                    case 't': character = '\t'; break;
+                    case 'r': character = '\r'; break;
+                    case 'n': character = '\n'; break;
+                    case 'v': character = '\v'; break;
+                    case 'f': character = '\f'; break;
+                    case '?':
+                    case '*':
+                    case '+':
+                    case '^':
+                    case '$':
+                    case '.':
+                    case '\\':
+                    case '|':
+                    case '{':
+                    case '}':
+                        break;
+                    default:
+                        return false;
+                }
+                break;
+            default:
+                break;
+        }
+        if(((_flags & CompileFlags::FLAG_ICASE) != 0) && (character >= 'A') && (character <= 'Z')) {
+            character = character - 'A' + 'a';
+        }
+        literal += character;
+    }
+    if((_flags & CompileFlags::FLAG_UTF8) != 0) {
+        for(size_t offset = 0, length = 0; offset < literal.size(); offset += length) {
+            length = Scan::utf8_length(literal.data() + offset, literal.size() - offset);
+            if(length == 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::accept_literals(StringIterator& pattern) -> bool
+{
+    StringIterator iterator(pattern);
+    StringIterator branch(pattern);
+
+    _trie.clear();
+    for(bool more = true; more != false;) {
+        more = accept_branch(iterator, branch);
+        if(accept_literal(branch, _branch) == false) {
+            return false;
+        }
+        _trie.insert(_branch);
+    }
+    _fixups.clear();
+    emit_trie(_trie, 0, _fixups);
+    for(const size_t fixup : _fixups) {
+        patch_target(fixup);
+    }
+    pattern = iterator;
+    return true;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::expect_expression(StringIterator& pattern) -> bool
+{
+    while(pattern) {
+        bool status = false;
+        const char character = pattern.peek();
+        switch(character) {
+            case '?':
+            case '*':
+            case '+':
+                return error(CompileError::ERR_UNEXPECTED_QUANTIFIER, pattern);
+            case '{':
+                status = expect_brace(pattern);
+                break;
+            case '^':
+                status = expect_stx(pattern);
+                break;
+            case '$':
+                status = expect_etx(pattern);
+                break;
+            case '.':
+                status = expect_any(pattern);
+                break;
+            case '\\':
+                status = expect_esc(pattern);
+                break;
+            default:
+                status = expect_chr(pattern);
+                break;
+        }
+        if(status == false) {
+            return false;
+        }
+    }
+    return true;
+}
 
+template <typename Trace>
+auto Compiler<Trace>::accept_quantifier(StringIterator& pattern) -> bool
+{
     if(pattern) {
         const char character = pattern.peek();
+        uint32_t   min = 0;
+        uint32_t   max = 0;
         switch(character) {
             case '?': // zero or one
                 pattern.advance(1);
-                emit_rep(0, +1);
+                min = 0;
+                max = +1;
                 break;
             case '*': // zero or more
                 pattern.advance(1);
-                emit_rep(0, -1);
+                min = 0;
+                max = -1;
                 break;
             case '+': // one or more
                 pattern.advance(1);
-                emit_rep(1, -1);
+                min = 1;
+                max = -1;
                 break;
-            default:
+            case '{': // counted
+                if(accept_bounds(pattern, min, max) == false) {
+                    return (_error.code == CompileError::ERR_NONE);
+                }
                 break;
+            default:
+                return true;
+        }
+        if((pattern) && (pattern.peek() == '+')) { // possessive
+            pattern.advance(1);
+            emit_pos(min, max);
+        }
+        else if((pattern) && (pattern.peek() == '?')) { // lazy
+            pattern.advance(1);
+            emit_lzy(min, max);
+        }
+        else {
+            emit_rep(min, max);
+        }
+    }
+    return true;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::accept_bounds(StringIterator& pattern, uint32_t& min, uint32_t& max) -> bool
+{
+    StringIterator iterator(pattern);
+
+    auto accept_number = [&](uint32_t& value) -> bool
+    {
+        bool digits = false;
+        value = 0;
+        while((iterator) && (iterator.peek() >= '0') && (iterator.peek() <= '9')) {
+            const uint32_t digit = iterator.next() - '0';
+            if(value > ((MAX_REPEAT - digit) / 10)) {
+                value = MAX_REPEAT + 1;
+            }
+            else {
+                value = (value * 10) + digit;
+            }
+            digits = true;
+        }
+        return digits;
+    };
+
+    auto accept_char = [&](const char expected) -> bool
+    {
+        if((iterator) && (iterator.peek() == expected)) {
+            iterator.advance(1);
+            return true;
         }
+        return false;
+    };
+
+    /* a brace that does not open {n}, {n,} or {m,n} is a literal */
+    if((accept_char('{') == false) || (accept_number(min) == false)) {
+        return false;
     }
-    return pattern.curr() - prev;
+    if(accept_char(',') == false) {
+        max = min;
+    }
+    else if(accept_number(max) == false) {
+        max = -1;
+    }
+    if(accept_char('}') == false) {
+        return false;
+    }
+    if((min > MAX_REPEAT) || ((max != static_cast<uint32_t>(-1)) && ((max > MAX_REPEAT) || (max < min)))) {
+        return error(CompileError::ERR_INVALID_REPETITION, pattern);
+    }
+    pattern = iterator;
+    return true;
 }
 
-auto Compiler::expect_stx(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::expect_brace(StringIterator& pattern) -> bool
 {
-    const auto prev = pattern.curr();
+    StringIterator probe(pattern);
+    uint32_t       min = 0;
+    uint32_t       max = 0;
 
+    if(accept_bounds(probe, min, max) != false) {
+        return error(CompileError::ERR_UNEXPECTED_QUANTIFIER, pattern);
+    }
+    if(_error.code != CompileError::ERR_NONE) {
+        return false;
+    }
+    return expect_chr(pattern);
+}
+
+template <typename Trace>
+auto Compiler<Trace>::expect_stx(StringIterator& pattern) -> bool
+{
     if(pattern) {
         char character = pattern.peek();
         if(character == '^') {
             pattern.advance(1);
-            emit_stx();
+            if((_flags & CompileFlags::FLAG_MULTILINE) != 0) {
+                emit_bol();
+            }
+            else {
+                emit_stx();
+            }
         }
         else {
-            throw std::runtime_error("unexpected character when stx was expected");
+            return error(CompileError::ERR_UNEXPECTED_CHARACTER, pattern);
         }
     }
     else {
-        throw std::runtime_error("unexpected end of string when stx was expected");
+        return error(CompileError::ERR_UNEXPECTED_END, pattern);
     }
-    return pattern.curr() - prev;
+    return true;
 }
 
-auto Compiler::expect_etx(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::expect_etx(StringIterator& pattern) -> bool
 {
-    const auto prev = pattern.curr();
-
     if(pattern) {
         char character = pattern.peek();
         if(character == '$') {
             pattern.advance(1);
-            emit_etx();
+            if((_flags & CompileFlags::FLAG_MULTILINE) != 0) {
+                emit_eol();
+            }
+            else {
+                emit_etx();
+            }
         }
         else {
-            throw std::runtime_error("unexpected character when etx was expected");
+            return error(CompileError::ERR_UNEXPECTED_CHARACTER, pattern);
         }
     }
     else {
-        throw std::runtime_error("unexpected end of string when etx was expected");
+        return error(CompileError::ERR_UNEXPECTED_END, pattern);
     }
-    return pattern.curr() - prev;
+    return true;
 }
 
-auto Compiler::expect_any(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::expect_any(StringIterator& pattern) -> bool
 {
-    const auto prev = pattern.curr();
-
     if(pattern) {
         char character = pattern.peek();
         if(character == '.') {
             pattern.advance(1);
-            pattern.advance(accept_quantifier(pattern));
-            emit_any();
+            if(accept_quantifier(pattern) == false) {
+                return false;
+            }
+            if((_flags & CompileFlags::FLAG_UTF8) != 0) {
+                emit_utf();
+            }
+            else {
+                emit_any();
+            }
         }
         else {
-            throw std::runtime_error("unexpected character when any was expected");
+            return error(CompileError::ERR_UNEXPECTED_CHARACTER, pattern);
         }
     }
     else {
-        throw std::runtime_error("unexpected end of string when any was expected");
+        return error(CompileError::ERR_UNEXPECTED_END, pattern);
     }
-    return pattern.curr() - prev;
+    return true;
 }
 
-auto Compiler::expect_esc(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::expect_esc(StringIterator& pattern) -> bool
 {
-    auto prev = pattern.curr();
-
     if(pattern) {
         char character = pattern.peek();
         if(character == '\\') {
             pattern.advance(1);
         }
         else {
-            throw std::runtime_error("unexpected character when esc was expected");
+            return error(CompileError::ERR_UNEXPECTED_CHARACTER, pattern);
         }
     }
     else {
-        throw std::runtime_error("unexpected end of string when esc was expected");
+        return error(CompileError::ERR_UNEXPECTED_END, pattern);
     }
     if(pattern) {
         char character = pattern.peek();
@@ -333,6 +965,9 @@ auto Compiler::expect_esc(StringIterator pattern) -> size_t
             case '$':
             case '.':
             case '\\':
+            case '|':
+            case '{':
+            case '}':
             case '\a':
             case '\b':
             case '\t':
@@ -341,40 +976,68 @@ auto Compiler::expect_esc(StringIterator pattern) -> size_t
             case '\v':
             case '\f':
                 pattern.advance(1);
-                pattern.advance(accept_quantifier(pattern));
-                emit_chr(character);
+                if(accept_quantifier(pattern) == false) {
+                    return false;
+                }
+                emit_literal(character);
                 break;
             default:
-                throw std::runtime_error("invalid escape sequence");
+                return error(CompileError::ERR_INVALID_ESCAPE, pattern);
         }
     }
     else {
-        throw std::runtime_error("unexpected end of string when esc was expected");
+        return error(CompileError::ERR_UNEXPECTED_END, pattern);
     }
-    return pattern.curr() - prev;
+    return true;
 }
 
-auto Compiler::expect_chr(StringIterator pattern) -> size_t
+template <typename Trace>
+auto Compiler<Trace>::expect_chr(StringIterator& pattern) -> bool
 {
-    const auto prev = pattern.curr();
-
     if(pattern) {
         char character = pattern.peek();
-        if(character != '\0') {
-            pattern.advance(1);
-            pattern.advance(accept_quantifier(pattern));
-            emit_chr(character);
+        if(((_flags & CompileFlags::FLAG_UTF8) != 0) && ((character & 0x80) != 0)) {
+            return expect_utf(pattern);
         }
-        else {
-            throw std::runtime_error("unexpected character when chr was expected");
+        pattern.advance(1);
+        if(accept_quantifier(pattern) == false) {
+            return false;
         }
+        emit_literal(character);
     }
     else {
-        throw std::runtime_error("unexpected end of string when chr was expected");
+        return error(CompileError::ERR_UNEXPECTED_END, pattern);
+    }
+    return true;
+}
+
+template <typename Trace>
+auto Compiler<Trace>::expect_utf(StringIterator& pattern) -> bool
+{
+    uint8_t      characters[4];
+    const size_t count = Scan::utf8_length(pattern.curr(), pattern.end() - pattern.curr());
+
+    if(count == 0) {
+        return error(CompileError::ERR_INVALID_UTF8, pattern);
     }
-    return pattern.curr() - prev;
+    for(size_t index = 0; index < count; ++index) {
+        characters[index] = pattern.next();
+    }
+    if(accept_quantifier(pattern) == false) {
+        return false;
+    }
+    emit_seq(characters, count);
+
+    return true;
 }
 
+// ---------------------------------------------------------------------------
+// explicit instantiations
+// ---------------------------------------------------------------------------
+
+template class Compiler<TraceOff>;
+template class Compiler<TraceOn>;
+
 // ---------------------------------------------------------------------------
 // End-Of-File
 // ---------------------------------------------------------------------------
@@ -19,11 +19,82 @@
 
 #include "loglevel.h"
 #include "bytecode.h"
+#include "scan.h"
+
+// ---------------------------------------------------------------------------
+// CompileFlags
+// ---------------------------------------------------------------------------
+
+struct CompileFlags
+{
+    static constexpr uint32_t FLAG_NONE      = 0x00;
+    static constexpr uint32_t FLAG_ICASE     = 0x01; // ASCII letters match both cases
+    static constexpr uint32_t FLAG_UTF8      = 0x02; // characters are utf-8 codepoints
+    static constexpr uint32_t FLAG_MULTILINE = 0x04; // '^' and '$' also match at line boundaries
+};
+
+// ---------------------------------------------------------------------------
+// CompileError
+// ---------------------------------------------------------------------------
+
+struct CompileError
+{
+    static constexpr uint32_t ERR_NONE                  = 0;
+    static constexpr uint32_t ERR_UNEXPECTED_QUANTIFIER = 1;
+    static constexpr uint32_t ERR_UNEXPECTED_CHARACTER  = 2;
+    static constexpr uint32_t ERR_UNEXPECTED_END        = 3;
+    static constexpr uint32_t ERR_INVALID_ESCAPE        = 4;
+    static constexpr uint32_t ERR_INVALID_UTF8          = 5;
+    static constexpr uint32_t ERR_INVALID_REPETITION    = 6;
+
+    static auto message(const uint32_t code) -> const char*;
+
+    uint32_t code;
+    size_t   offset;
+};
+
+// ---------------------------------------------------------------------------
+// LiteralTrie: the literal branches of an alternation, merged by prefix
+// ---------------------------------------------------------------------------
+
+struct LiteralTrie
+{
+    struct Node
+    {
+        uint32_t child;   // first child or zero
+        uint32_t sibling; // next sibling or zero
+        uint8_t  byte;    // byte leading to this node
+        bool     final;   // a branch ends here
+    };
+
+    std::vector<Node> nodes;
+
+    auto clear() -> void;
+
+    auto insert(const std::string& literal) -> void;
+};
+
+// ---------------------------------------------------------------------------
+// Literal: a program that only matches a fixed string
+// ---------------------------------------------------------------------------
+
+struct Literal
+{
+    std::string bytes;
+    bool        pure;  // the whole program is this string and its anchors
+    bool        begin; // anchored at the start of the text
+    bool        end;   // anchored at the end of the text
+
+    auto clear() -> void;
+
+    auto search(const char* data, const size_t size, size_t& position) const -> bool;
+};
 
 // ---------------------------------------------------------------------------
 // Compiler
 // ---------------------------------------------------------------------------
 
+template <typename Trace>
 class Compiler
 {
 public: // public interface
@@ -39,51 +110,124 @@ public: // public interface
 
     virtual ~Compiler() = default;
 
+    static constexpr uint32_t MAX_REPEAT = 65535; // largest {m,n} bound
+
     auto compile(const std::string& string) -> bool;
 
+    auto compile(const char* data, const size_t size) -> bool;
+
+    auto compile(const char* data, const size_t size, const uint32_t flags) -> bool;
+
+    auto error() const -> const CompileError&
+    {
+        return _error;
+    }
+
+    auto literal() const -> const Literal&
+    {
+        return _literal;
+    }
+
 protected: // protected interface
-    auto begin(const std::string& string) -> void;
+    auto begin(const char* data, const size_t size, const uint32_t flags) -> void;
 
     auto success() -> bool;
 
     auto failure() -> bool;
 
+    auto analyze_literal() -> void;
+
     auto clear() -> void;
 
+    auto reserve(const size_t size) -> void;
+
+    auto analyze() -> void;
+
+    auto error(const uint32_t code, const StringIterator& pattern) -> bool;
+
     auto emit_nop() -> void;
 
     auto emit_stx() -> void;
 
     auto emit_etx() -> void;
 
+    auto emit_bol() -> void;
+
+    auto emit_eol() -> void;
+
     auto emit_any() -> void;
 
     auto emit_chr(const uint8_t character) -> void;
 
+    auto emit_ch2(const uint8_t character1, const uint8_t character2) -> void;
+
+    auto emit_literal(const uint8_t character) -> void;
+
+    auto emit_seq(const uint8_t* characters, const uint8_t count) -> void;
+
+    auto emit_utf() -> void;
+
     auto emit_rep(const uint32_t min, const uint32_t max) -> void;
 
+    auto emit_pos(const uint32_t min, const uint32_t max) -> void;
+
+    auto emit_lzy(const uint32_t min, const uint32_t max) -> void;
+
+    auto emit_alt(const uint32_t target) -> size_t;
+
+    auto emit_jmp(const uint32_t target) -> size_t;
+
+    auto emit_jtb(const uint8_t lower, const uint8_t upper) -> size_t;
+
+    auto emit_run(const std::string& characters) -> void;
+
+    auto emit_trie(const LiteralTrie& trie, uint32_t node, std::vector<size_t>& fixups) -> void;
+
+    auto patch_target(const size_t offset) -> void;
+
     auto emit_err() -> void;
 
     auto emit_ret() -> void;
 
-    auto expect_expression(StringIterator pattern) -> size_t;
+    auto expect_alternation(StringIterator& pattern) -> bool;
+
+    auto accept_branch(StringIterator& pattern, StringIterator& branch) -> bool;
+
+    auto accept_literal(StringIterator branch, std::string& literal) -> bool;
+
+    auto accept_literals(StringIterator& pattern) -> bool;
+
+    auto expect_expression(StringIterator& pattern) -> bool;
+
+    auto accept_quantifier(StringIterator& pattern) -> bool;
+
+    auto accept_bounds(StringIterator& pattern, uint32_t& min, uint32_t& max) -> bool;
+
+    auto expect_brace(StringIterator& pattern) -> bool;
 
-    auto accept_quantifier(StringIterator pattern) -> size_t;
+    auto expect_stx(StringIterator& pattern) -> bool;
 
-    auto expect_stx(StringIterator pattern) -> size_t;
+    auto expect_etx(StringIterator& pattern) -> bool;
 
-    auto expect_etx(StringIterator pattern) -> size_t;
+    auto expect_any(StringIterator& pattern) -> bool;
 
-    auto expect_any(StringIterator pattern) -> size_t;
+    auto expect_esc(StringIterator& pattern) -> bool;
 
-    auto expect_esc(StringIterator pattern) -> size_t;
+    auto expect_chr(StringIterator& pattern) -> bool;
 
-    auto expect_chr(StringIterator pattern) -> size_t;
+    auto expect_utf(StringIterator& pattern) -> bool;
 
 protected: // protected data
-    OStream&       _ostream;
-    const uint32_t _loglevel;
-    ByteCode&      _bytecode;
+    OStream&            _ostream;
+    const uint32_t      _loglevel;
+    ByteCode&           _bytecode;
+    const char*         _pattern;
+    uint32_t            _flags;
+    CompileError        _error;
+    Literal             _literal;
+    LiteralTrie         _trie;    // the buffers below keep their capacity across compiles
+    std::string         _branch;
+    std::vector<size_t> _fixups;
 };
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,71 @@
+/*
+ * engine.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include "engine.h"
+
+// ---------------------------------------------------------------------------
+// Engine
+// ---------------------------------------------------------------------------
+
+auto Engine::name(const uint32_t engine) -> const char*
+{
+    switch(engine) {
+        case ENGINE_BACKTRACK:
+            return "backtrack";
+        case ENGINE_DFA:
+            return "dfa";
+        case ENGINE_AUTO:
+            return "auto";
+        case ENGINE_FULLDFA:
+            return "fulldfa";
+        case ENGINE_LITERAL:
+            return "literal";
+        default:
+            break;
+    }
+    return "???";
+}
+
+auto Engine::parse(const std::string& name) -> uint32_t
+{
+    for(uint32_t engine = 0; engine < ENGINE_COUNT; ++engine) {
+        if(name == Engine::name(engine)) {
+            return engine;
+        }
+    }
+    throw std::runtime_error(std::string("invalid engine") + ' ' + '\'' + name + '\'');
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
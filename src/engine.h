@@ -0,0 +1,42 @@
+/*
+ * engine.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Engine_h__
+#define __Engine_h__
+
+// ---------------------------------------------------------------------------
+// Engine
+// ---------------------------------------------------------------------------
+
+struct Engine
+{
+    static constexpr uint32_t ENGINE_BACKTRACK = 0;
+    static constexpr uint32_t ENGINE_DFA       = 1;
+    static constexpr uint32_t ENGINE_AUTO      = 2;
+    static constexpr uint32_t ENGINE_FULLDFA   = 3;
+    static constexpr uint32_t ENGINE_COUNT     = 4;
+    static constexpr uint32_t ENGINE_LITERAL   = 4; // picked by the selector only
+
+    static auto name(const uint32_t engine) -> const char*;
+
+    static auto parse(const std::string& name) -> uint32_t;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Engine_h__ */
@@ -30,35 +30,117 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 #include <stdexcept>
 #include "executor.h"
 
+// ---------------------------------------------------------------------------
+// FLATTEN: the exec_* lambdas of a template instantiation have vague linkage,
+// so they must be explicitly flattened into match() to be inlined
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__)
+#define FLATTEN __attribute__((flatten))
+#else
+#define FLATTEN
+#endif
+
 // ---------------------------------------------------------------------------
 // Executor
 // ---------------------------------------------------------------------------
 
-Executor::Executor(ByteCode& bytecode, OStream& ostream, const uint32_t loglevel)
-    : _ostream(std::cout)
+template <typename Trace>
+Executor<Trace>::Executor(ByteCode& bytecode, Stats& stats, OStream& ostream, const uint32_t loglevel)
+    : _ostream(ostream)
     , _loglevel(loglevel)
     , _bytecode(bytecode)
+    , _stats(stats)
+    , _depth(0)
+    , _earliest(false)
+    , _position(0)
+    , _end(0)
+{
+}
+
+template <typename Trace>
+auto Executor<Trace>::execute(const std::string& string) -> bool
 {
+    return execute(string.data(), string.size());
 }
 
-auto Executor::execute(const std::string& string) -> bool
+template <typename Trace>
+auto Executor<Trace>::is_match(const char* data, const size_t size) -> bool
+{
+    _earliest = true;
+    const bool status = execute(data, size);
+    _earliest = false;
+
+    return status;
+}
+
+template <typename Trace>
+auto Executor<Trace>::execute(const char* data, const size_t size) -> bool
 {
     ByteCodeIterator bytecode(_bytecode);
-    StringIterator   iterator(string);
+    StringIterator   iterator(data, size);
+    uint8_t          lower = 0;
+    uint8_t          upper = 0;
+    uint64_t         first[4];
+    const bool       skip  = prefilter(lower, upper);
+    const bool       table = ((skip == false) && (dispatch(first) != false));
+    const bool       lines = line_anchored();
+    const uint64_t   least = _bytecode.min_length();
 
     try {
-        begin(string);
-        do {
+        begin(data, size);
+        if(_bytecode.rejects(size) != false) {
+            return failure();
+        }
+        for(;;) {
+            if(skip != false) {
+                const size_t available = iterator.end() - iterator.curr();
+                const size_t offset    = Scan::find_pair(iterator.curr(), available, lower, upper);
+                if(offset == available) {
+                    break;
+                }
+                iterator.advance(offset);
+            }
+            else if(table != false) {
+                while(iterator) {
+                    const uint8_t byte = iterator.peek();
+                    if(((first[byte >> 6] >> (byte & 63)) & 1) != 0) {
+                        break;
+                    }
+                    iterator.advance(1);
+                }
+                if(!iterator) {
+                    break;
+                }
+            }
+            if(static_cast<uint64_t>(iterator.end() - iterator.curr()) < least) {
+                break;
+            }
+            _stats.count_start_offset();
             if(match(bytecode, iterator) != false) {
+                _position = iterator.curr() - iterator.begin();
                 return success();
             }
+            if((!iterator) || (_bytecode.anchored_begin() != false)) {
+                break;
+            }
+            if(lines != false) {
+                /* a line anchored program can only start right after a newline */
+                const size_t available = iterator.end() - iterator.curr();
+                const size_t offset    = Scan::line_end(iterator.curr(), available);
+                if(offset == available) {
+                    break;
+                }
+                iterator.advance(offset + 1);
+            }
             else {
                 iterator.advance(1);
             }
-        } while(iterator);
+        }
     }
     catch(const std::exception& e) {
         if(_loglevel >= LogLevel::LOG_ERROR) {
@@ -68,14 +150,135 @@ auto Executor::execute(const std::string& string) -> bool
     return failure();
 }
 
-auto Executor::begin(const std::string& string) -> void
+template <typename Trace>
+auto Executor<Trace>::prefiltered(uint64_t* first) -> bool
 {
+    uint8_t lower = 0;
+    uint8_t upper = 0;
+
+    /* the set receives the bytes on which the search stops to try a match */
+    if(prefilter(lower, upper) != false) {
+        first[0] = first[1] = first[2] = first[3] = 0;
+        first[lower >> 6] |= (static_cast<uint64_t>(1) << (lower & 63));
+        first[upper >> 6] |= (static_cast<uint64_t>(1) << (upper & 63));
+        return true;
+    }
+    if(dispatch(first) != false) {
+        return true;
+    }
+    if(line_anchored() != false) {
+        first[0] = first[1] = first[2] = first[3] = 0;
+        first['\n' >> 6] |= (static_cast<uint64_t>(1) << ('\n' & 63));
+        return true;
+    }
+    return false;
+}
+
+template <typename Trace>
+auto Executor<Trace>::prefilter(uint8_t& lower, uint8_t& upper) -> bool
+{
+    ByteCodeIterator bytecode(_bytecode);
+
+    if(bytecode.next_byte() != ByteCode::OP_NOP) {
+        return false;
+    }
+    uint8_t opcode = bytecode.next_byte();
+    if((opcode == ByteCode::OP_REP) || (opcode == ByteCode::OP_POS) || (opcode == ByteCode::OP_LZY)) {
+        const uint32_t repeat_min = bytecode.next_long();
+        const uint32_t repeat_max = bytecode.next_long();
+        if((repeat_min == 0) || (repeat_max == 0)) {
+            return false;
+        }
+        opcode = bytecode.next_byte();
+    }
+    switch(opcode) {
+        case ByteCode::OP_CHR:
+            lower = upper = bytecode.next_byte();
+            return true;
+        case ByteCode::OP_CH2:
+            lower = bytecode.next_byte();
+            upper = bytecode.next_byte();
+            return true;
+        case ByteCode::OP_SEQ:
+            static_cast<void>(bytecode.next_byte());
+            lower = upper = bytecode.next_byte();
+            return true;
+        case ByteCode::OP_JTB:
+            return prefilter_table(bytecode, lower, upper);
+        default:
+            break;
+    }
+    return false;
+}
+
+template <typename Trace>
+auto Executor<Trace>::dispatch(uint64_t* first) -> bool
+{
+    ByteCodeIterator bytecode(_bytecode);
+
+    if((bytecode.next_byte() != ByteCode::OP_NOP)
+    || (bytecode.next_byte() != ByteCode::OP_JTB)) {
+        return false;
+    }
+    const uint8_t lower = bytecode.next_byte();
+    const uint8_t upper = bytecode.next_byte();
+
+    /* a program starting with a jump table can only start on one of its characters */
+    first[0] = first[1] = first[2] = first[3] = 0;
+    for(uint32_t byte = lower; byte <= upper; ++byte) {
+        if(bytecode.next_long() != 0) {
+            first[byte >> 6] |= (static_cast<uint64_t>(1) << (byte & 63));
+        }
+    }
+    return true;
+}
+
+template <typename Trace>
+auto Executor<Trace>::line_anchored() -> bool
+{
+    ByteCodeIterator bytecode(_bytecode);
+
+    return (bytecode.next_byte() == ByteCode::OP_NOP)
+        && (bytecode.next_byte() == ByteCode::OP_BOL);
+}
+
+template <typename Trace>
+auto Executor<Trace>::prefilter_table(ByteCodeIterator& bytecode, uint8_t& lower, uint8_t& upper) -> bool
+{
+    const uint8_t first = bytecode.next_byte();
+    const uint8_t last  = bytecode.next_byte();
+    uint32_t      count = 0;
+
+    /* the pair scan only helps when the branches start with at most two characters */
+    for(uint32_t byte = first; byte <= last; ++byte) {
+        if(bytecode.next_long() != 0) {
+            if(count == 0) {
+                lower = upper = static_cast<uint8_t>(byte);
+            }
+            else {
+                upper = static_cast<uint8_t>(byte);
+            }
+            if(++count > 2) {
+                return false;
+            }
+        }
+    }
+    return count != 0;
+}
+
+template <typename Trace>
+auto Executor<Trace>::begin(const char* data, const size_t size) -> void
+{
+    _depth = 0;
     if(_loglevel >= LogLevel::LOG_PRINT) {
-        _ostream << "🔵" << ' ' << "comparing" << '<' << string << '>' << std::endl;
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        _ostream.write(data, size);
+        _ostream << '>' << std::endl;
     }
 }
 
-auto Executor::success() -> bool
+template <typename Trace>
+auto Executor<Trace>::success() -> bool
 {
     if(_loglevel >= LogLevel::LOG_ALERT) {
         _ostream << "🟢" << ' ' << "the string matches the regular expression" << std::endl;
@@ -83,7 +286,8 @@ auto Executor::success() -> bool
     return true;
 }
 
-auto Executor::failure() -> bool
+template <typename Trace>
+auto Executor<Trace>::failure() -> bool
 {
     if(_loglevel >= LogLevel::LOG_ERROR) {
         _ostream << "🔴" << ' ' << "the string does not match the regular expression" << std::endl;
@@ -91,16 +295,18 @@ auto Executor::failure() -> bool
     return false;
 }
 
-auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
+template <typename Trace>
+FLATTEN auto Executor<Trace>::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
 {
     auto     prev_iter  = iterator;
     uint32_t repeat_cnt = 0;
     uint32_t repeat_max = 0;
     uint32_t repeat_min = 0;
+    uint32_t repeat_len = 1;
 
     auto exec_nop = [&]() -> bool
     {
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:nop" << std::endl;
         }
         return true;
@@ -108,7 +314,7 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
 
     auto exec_stx = [&]() -> bool
     {
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:stx" << std::endl;
         }
         return iterator.at_begin();
@@ -116,21 +322,38 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
 
     auto exec_etx = [&]() -> bool
     {
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:etx" << std::endl;
         }
         return iterator.at_end();
     };
 
+    auto exec_bol = [&]() -> bool
+    {
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:bol" << std::endl;
+        }
+        return iterator.at_line_begin();
+    };
+
+    auto exec_eol = [&]() -> bool
+    {
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:eol" << std::endl;
+        }
+        return iterator.at_line_end();
+    };
+
     auto exec_any = [&]() -> bool
     {
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:any" << std::endl;
         }
-        while((iterator) && (repeat_cnt < repeat_max)) {
-            iterator.advance(1);
-            ++repeat_cnt;
-        }
+        const size_t available = iterator.end() - iterator.curr();
+        const size_t count     = std::min(available, static_cast<size_t>(repeat_max - repeat_cnt));
+        iterator.advance(count);
+        repeat_cnt += count;
+        _stats.count_bytes(repeat_cnt);
         if((repeat_cnt >= repeat_min)
         && (repeat_cnt <= repeat_max)) {
             return true;
@@ -138,16 +361,73 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
         return false;
     };
 
+    auto scan_run = [&](const uint8_t lower, const uint8_t upper) -> void
+    {
+        const size_t available = iterator.end() - iterator.curr();
+        const size_t limit     = std::min(available, static_cast<size_t>(repeat_max - repeat_cnt));
+        size_t       count     = 0;
+        if(limit == 1) {
+            const uint8_t byte = iterator.peek();
+            count = ((byte == lower) || (byte == upper) ? 1 : 0);
+        }
+        else if(limit != 0) {
+            count = Scan::span_pair(iterator.curr(), limit, lower, upper);
+        }
+        iterator.advance(count);
+        repeat_cnt += count;
+    };
+
     auto exec_chr = [&]() -> bool
     {
         const char expected = bytecode.next_byte();
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:chr" << ' ' << '<' << expected << '>' << std::endl;
         }
-        while((iterator) && (repeat_cnt < repeat_max) && (iterator.peek() == expected)) {
-            iterator.advance(1);
+        scan_run(expected, expected);
+        _stats.count_bytes(repeat_cnt);
+        if((repeat_cnt >= repeat_min)
+        && (repeat_cnt <= repeat_max)) {
+            return true;
+        }
+        return false;
+    };
+
+    auto exec_ch2 = [&]() -> bool
+    {
+        const char expected1 = bytecode.next_byte();
+        const char expected2 = bytecode.next_byte();
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:ch2" << ' ' << '<' << expected1 << ',' << expected2 << '>' << std::endl;
+        }
+        scan_run(expected1, expected2);
+        _stats.count_bytes(repeat_cnt);
+        if((repeat_cnt >= repeat_min)
+        && (repeat_cnt <= repeat_max)) {
+            return true;
+        }
+        return false;
+    };
+
+    auto exec_seq = [&]() -> bool
+    {
+        const uint8_t  count    = bytecode.next_byte();
+        const uint8_t* expected = bytecode.curr();
+        bytecode.advance(count);
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:seq" << ' ' << '<';
+            _ostream.write(reinterpret_cast<const char*>(expected), count);
+            _ostream << '>' << std::endl;
+        }
+        repeat_len = count;
+        while(repeat_cnt < repeat_max) {
+            if((static_cast<size_t>(iterator.end() - iterator.curr()) < count)
+            || (::memcmp(iterator.curr(), expected, count) != 0)) {
+                break;
+            }
+            iterator.advance(count);
             ++repeat_cnt;
         }
+        _stats.count_bytes(repeat_cnt * count);
         if((repeat_cnt >= repeat_min)
         && (repeat_cnt <= repeat_max)) {
             return true;
@@ -155,49 +435,225 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
         return false;
     };
 
-    auto exec_rep = [&]() -> bool
+    auto exec_utf = [&]() -> bool
     {
-        repeat_min = bytecode.next_long();
-        repeat_max = bytecode.next_long();
-        if(_loglevel >= LogLevel::LOG_TRACE) {
-            _ostream << "🟣" << ' ' << "exec:rep" << ' ' << '<' << repeat_min << ',' << repeat_max << '>' << std::endl;
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:utf" << std::endl;
         }
-        bool status = false;
-        switch(bytecode.next_byte()) {
-            case ByteCode::OP_ANY:
-                status = exec_any();
+        repeat_len = 0;
+        while((iterator) && (repeat_cnt < repeat_max)) {
+            const size_t available = iterator.end() - iterator.curr();
+            const size_t ascii     = Scan::span_ascii(iterator.curr(), std::min(available, static_cast<size_t>(repeat_max - repeat_cnt)));
+            iterator.advance(ascii);
+            repeat_cnt += ascii;
+            if((!iterator) || (repeat_cnt >= repeat_max)) {
+                break;
+            }
+            const size_t length = Scan::utf8_length(iterator.curr(), iterator.end() - iterator.curr());
+            if(length == 0) {
                 break;
+            }
+            iterator.advance(length);
+            ++repeat_cnt;
+        }
+        _stats.count_bytes(iterator.curr() - prev_iter.curr());
+        if((repeat_cnt >= repeat_min)
+        && (repeat_cnt <= repeat_max)) {
+            return true;
+        }
+        return false;
+    };
+
+    auto exec_atom = [&](const uint8_t opcode) -> bool
+    {
+        switch(opcode) {
+            case ByteCode::OP_ANY:
+                return exec_any();
             case ByteCode::OP_CHR:
-                status = exec_chr();
+                return exec_chr();
+            case ByteCode::OP_CH2:
+                return exec_ch2();
+            case ByteCode::OP_SEQ:
+                return exec_seq();
+            case ByteCode::OP_UTF:
+                return exec_utf();
+            default:
                 break;
+        }
+        throw std::runtime_error("unexpected non-repeatable opcode");
+    };
+
+    auto follow_pair = [&](ByteCodeIterator next, uint8_t& lower, uint8_t& upper) -> bool
+    {
+        uint8_t opcode = next.next_byte();
+        if((opcode == ByteCode::OP_REP) || (opcode == ByteCode::OP_POS) || (opcode == ByteCode::OP_LZY)) {
+            if(next.next_long() == 0) {
+                return false;
+            }
+            static_cast<void>(next.next_long());
+            opcode = next.next_byte();
+        }
+        switch(opcode) {
+            case ByteCode::OP_CHR:
+                lower = upper = next.next_byte();
+                return true;
+            case ByteCode::OP_CH2:
+                lower = next.next_byte();
+                upper = next.next_byte();
+                return true;
+            case ByteCode::OP_SEQ:
+                static_cast<void>(next.next_byte());
+                lower = upper = next.next_byte();
+                return true;
             default:
-                throw std::runtime_error("unexpected non-repeatable opcode");
+                break;
+        }
+        return false;
+    };
+
+    /*
+     * a lazy repeat consumes its minimum and then grows one unit at a time,
+     * trying the rest of the program at each length; a run of any byte that
+     * is followed by a literal jumps straight to the next candidate position
+     */
+    auto exec_lazy = [&](const uint32_t max) -> bool
+    {
+        const ByteCodeIterator atom(bytecode);
+        const uint8_t          opcode = bytecode.next_byte();
+        uint8_t                lower  = 0;
+        uint8_t                upper  = 0;
+        repeat_max = repeat_min;
+        if(exec_atom(opcode) == false) {
+            return false;
+        }
+        const bool skip = ((opcode == ByteCode::OP_ANY) && (follow_pair(bytecode, lower, upper) != false));
+        for(;;) {
+            if(match(bytecode, iterator) != false) {
+                return true;
+            }
+            if(repeat_cnt >= max) {
+                break;
+            }
+            _stats.count_backtrack();
+            if(skip != false) {
+                const size_t available = iterator.end() - iterator.curr();
+                const size_t limit     = std::min(available - (available != 0 ? 1 : 0), static_cast<size_t>(max - repeat_cnt));
+                const size_t offset    = (limit != 0 ? Scan::find_pair(iterator.curr() + 1, limit, lower, upper) : 0);
+                if(offset == limit) {
+                    break;
+                }
+                iterator.advance(offset + 1);
+                repeat_cnt += offset + 1;
+                continue;
+            }
+            const char* curr = iterator.curr();
+            bytecode   = atom;
+            repeat_max = repeat_cnt + 1;
+            static_cast<void>(exec_atom(bytecode.next_byte()));
+            if(iterator.curr() == curr) {
+                break;
+            }
+        }
+        return false;
+    };
+
+    auto exec_rep = [&](const uint8_t mode) -> bool
+    {
+        repeat_min = bytecode.next_long();
+        repeat_max = bytecode.next_long();
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:" << ByteCode::opcode_name(mode) << ' ' << '<' << repeat_min << ',' << repeat_max << '>' << std::endl;
+        }
+        const uint8_t opcode = bytecode.curr()[0];
+        _stats.count_instruction(opcode);
+        /* the earliest match never needs a greedy run over any character */
+        if((mode == ByteCode::OP_LZY)
+        || ((mode == ByteCode::OP_REP) && (_earliest != false) && ((opcode == ByteCode::OP_ANY) || (opcode == ByteCode::OP_UTF)))) {
+            return exec_lazy(repeat_max);
+        }
+        const bool status = exec_atom(bytecode.next_byte());
+        /* a possessive repeat keeps its longest run and leaves no backtracking point */
+        if((status != false) && (mode == ByteCode::OP_POS)) {
+            return true;
         }
         if(status != false) {
-            while(repeat_cnt != 0) {
-                iterator = prev_iter;
-                iterator.advance(repeat_cnt);
+            for(;;) {
                 if(match(bytecode, iterator) != false) {
                     return true;
                 }
-                else {
-                    --repeat_cnt;
+                if(repeat_cnt <= repeat_min) {
+                    break;
                 }
-            }
-            if(repeat_min == 0) {
-                iterator = prev_iter;
-                if(match(bytecode, iterator) != false) {
-                    return true;
+                _stats.count_backtrack();
+                --repeat_cnt;
+                if(repeat_len != 0) {
+                    iterator = prev_iter;
+                    iterator.advance(repeat_cnt * repeat_len);
+                }
+                else {
+                    do {
+                        iterator.retreat(1);
+                    } while((iterator.curr() != prev_iter.curr()) && ((iterator.peek() & 0xc0) == 0x80));
                 }
             }
         }
         return false;
     };
 
+    auto exec_alt = [&]() -> bool
+    {
+        const uint32_t target = bytecode.next_long();
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:alt" << ' ' << '<' << target << '>' << std::endl;
+        }
+        if(match(bytecode, iterator) != false) {
+            bytecode.to_end();
+            return true;
+        }
+        _stats.count_backtrack();
+        bytecode.jump(target);
+        return true;
+    };
+
+    auto exec_jmp = [&]() -> bool
+    {
+        const uint32_t target = bytecode.next_long();
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:jmp" << ' ' << '<' << target << '>' << std::endl;
+        }
+        bytecode.jump(target);
+        return true;
+    };
+
+    auto exec_jtb = [&]() -> bool
+    {
+        const uint8_t lower = bytecode.next_byte();
+        const uint8_t upper = bytecode.next_byte();
+        if(Trace::enabled) {
+            _ostream << "🟣" << ' ' << "exec:jtb" << ' ' << '<' << lower << ',' << upper << '>' << std::endl;
+        }
+        if(!iterator) {
+            return false;
+        }
+        const uint8_t byte = iterator.peek();
+        if((byte < lower) || (byte > upper)) {
+            return false;
+        }
+        bytecode.advance((byte - lower) * 4);
+        const uint32_t target = bytecode.next_long();
+        if(target == 0) {
+            return false;
+        }
+        iterator.advance(1);
+        _stats.count_bytes(1);
+        bytecode.jump(target);
+        return true;
+    };
+
     auto exec_err = [&]() -> bool
     {
         bytecode.to_end();
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:err" << std::endl;
         }
         return false;
@@ -206,7 +662,8 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
     auto exec_ret = [&]() -> bool
     {
         bytecode.to_end();
-        if(_loglevel >= LogLevel::LOG_TRACE) {
+        _end = iterator.curr() - iterator.begin();
+        if(Trace::enabled) {
             _ostream << "🟣" << ' ' << "exec:ret" << std::endl;
         }
         return true;
@@ -220,7 +677,10 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
             repeat_cnt = 0;
             repeat_min = 1;
             repeat_max = 1;
-            switch(bytecode.next_byte()) {
+            repeat_len = 1;
+            const uint8_t opcode = bytecode.next_byte();
+            _stats.count_instruction(opcode);
+            switch(opcode) {
                 case ByteCode::OP_NOP:
                     status = exec_nop();
                     break;
@@ -230,14 +690,40 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
                 case ByteCode::OP_ETX:
                     status = exec_etx();
                     break;
+                case ByteCode::OP_BOL:
+                    status = exec_bol();
+                    break;
+                case ByteCode::OP_EOL:
+                    status = exec_eol();
+                    break;
                 case ByteCode::OP_ANY:
                     status = exec_any();
                     break;
                 case ByteCode::OP_CHR:
                     status = exec_chr();
                     break;
+                case ByteCode::OP_CH2:
+                    status = exec_ch2();
+                    break;
+                case ByteCode::OP_SEQ:
+                    status = exec_seq();
+                    break;
+                case ByteCode::OP_UTF:
+                    status = exec_utf();
+                    break;
                 case ByteCode::OP_REP:
-                    status = exec_rep();
+                case ByteCode::OP_POS:
+                case ByteCode::OP_LZY:
+                    status = exec_rep(opcode);
+                    break;
+                case ByteCode::OP_ALT:
+                    status = exec_alt();
+                    break;
+                case ByteCode::OP_JMP:
+                    status = exec_jmp();
+                    break;
+                case ByteCode::OP_JTB:
+                    status = exec_jtb();
                     break;
                 case ByteCode::OP_ERR:
                     status = exec_err();
@@ -255,9 +741,33 @@ auto Executor::match(ByteCodeIterator bytecode, StringIterator iterator) -> bool
         return true;
     };
 
-    return do_match();
+    auto do_enter = [&]() -> void
+    {
+        if(Stats::enabled) {
+            _stats.count_depth(++_depth);
+        }
+    };
+
+    auto do_leave = [&](const bool status) -> bool
+    {
+        if(Stats::enabled) {
+            --_depth;
+        }
+        return status;
+    };
+
+    do_enter();
+
+    return do_leave(do_match());
 }
 
+// ---------------------------------------------------------------------------
+// explicit instantiations
+// ---------------------------------------------------------------------------
+
+template class Executor<TraceOff>;
+template class Executor<TraceOn>;
+
 // ---------------------------------------------------------------------------
 // End-Of-File
 // ---------------------------------------------------------------------------
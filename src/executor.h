@@ -19,15 +19,18 @@
 
 #include "loglevel.h"
 #include "bytecode.h"
+#include "stats.h"
+#include "scan.h"
 
 // ---------------------------------------------------------------------------
 // Executor
 // ---------------------------------------------------------------------------
 
+template <typename Trace>
 class Executor
 {
 public: // public interface
-    Executor(ByteCode&, OStream&, const uint32_t loglevel);
+    Executor(ByteCode&, Stats&, OStream&, const uint32_t loglevel);
 
     Executor(Executor&&) = delete;
 
@@ -41,8 +44,32 @@ public: // public interface
 
     auto execute(const std::string& string) -> bool;
 
+    auto execute(const char* data, const size_t size) -> bool;
+
+    auto is_match(const char* data, const size_t size) -> bool;
+
+    auto prefiltered(uint64_t* first) -> bool;
+
+    auto position() const -> size_t
+    {
+        return _position;
+    }
+
+    auto length() const -> size_t
+    {
+        return _end - _position;
+    }
+
 protected: // protected interface
-    auto begin(const std::string& string) -> void;
+    auto prefilter(uint8_t& lower, uint8_t& upper) -> bool;
+
+    auto prefilter_table(ByteCodeIterator& bytecode, uint8_t& lower, uint8_t& upper) -> bool;
+
+    auto dispatch(uint64_t* first) -> bool;
+
+    auto line_anchored() -> bool;
+
+    auto begin(const char* data, const size_t size) -> void;
 
     auto success() -> bool;
 
@@ -54,6 +81,11 @@ protected: // protected data
     OStream&       _ostream;
     const uint32_t _loglevel;
     ByteCode&      _bytecode;
+    Stats&         _stats;
+    uint64_t       _depth;
+    bool           _earliest;
+    size_t         _position;
+    size_t         _end;
 };
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,667 @@
+/*
+ * fulldfa.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include "fulldfa.h"
+
+// ---------------------------------------------------------------------------
+// FullDFA
+// ---------------------------------------------------------------------------
+
+FullDFA::FullDFA(Stats& stats, OStream& ostream, const uint32_t loglevel)
+    : _ostream(ostream)
+    , _loglevel(loglevel)
+    , _stats(stats)
+    , _map()
+    , _final()
+    , _storage()
+    , _table(nullptr)
+    , _fingerprint(0)
+    , _classes(0)
+    , _stride(0)
+    , _states(0)
+    , _start(STATE_DEAD)
+    , _position(0)
+    , _valid(false)
+{
+    clear();
+}
+
+auto FullDFA::clear() -> void
+{
+    std::fill(_map, _map + 256, 0);
+    _final.clear();
+    _storage.clear();
+    _table       = nullptr;
+    _fingerprint = 0;
+    _classes     = 0;
+    _stride      = 0;
+    _states      = 0;
+    _start       = STATE_DEAD;
+    _valid       = false;
+}
+
+auto FullDFA::bytes_reserved() const -> size_t
+{
+    return (_final.capacity()   * sizeof(uint8_t))
+         + (_storage.capacity() * sizeof(uint32_t));
+}
+
+auto FullDFA::build(const ByteCode& bytecode, const Automaton& automaton) -> bool
+{
+    using Key = std::pair<uint8_t, std::vector<uint32_t>>;
+
+    std::vector<uint32_t> marks(automaton.size(), 0);
+    std::vector<uint32_t> stack;
+    std::vector<uint32_t> nodes;
+    std::vector<Key>      subsets;
+    std::map<Key, uint32_t> indexes;
+    std::vector<uint32_t> delta;
+    std::vector<uint8_t>  final;
+    uint8_t               first[256];
+    uint32_t              generation = 0;
+    uint32_t              start      = STATE_DEAD;
+
+    auto closure = [&](const uint8_t before, const uint8_t after) -> bool
+    {
+        bool accept = false;
+        nodes.clear();
+        ++generation;
+        while(stack.empty() == false) {
+            const uint32_t index = stack.back();
+            stack.pop_back();
+            if(marks[index] == generation) {
+                continue;
+            }
+            marks[index] = generation;
+            const Automaton::Node& node(automaton.node(index));
+            switch(node.type) {
+                case Automaton::NODE_BYTE:
+                    nodes.push_back(index);
+                    break;
+                case Automaton::NODE_SPLIT:
+                    stack.push_back(node.alt);
+                    stack.push_back(node.out);
+                    break;
+                case Automaton::NODE_STX:
+                    if((before & AT_TEXT) != 0) {
+                        stack.push_back(node.out);
+                    }
+                    break;
+                case Automaton::NODE_ETX:
+                    if((after & AT_TEXT) != 0) {
+                        stack.push_back(node.out);
+                    }
+                    else {
+                        nodes.push_back(index);
+                    }
+                    break;
+                case Automaton::NODE_BOL:
+                    if((before & AT_LINE) != 0) {
+                        stack.push_back(node.out);
+                    }
+                    break;
+                case Automaton::NODE_EOL:
+                    if((after & AT_LINE) != 0) {
+                        stack.push_back(node.out);
+                    }
+                    else {
+                        nodes.push_back(index);
+                    }
+                    break;
+                case Automaton::NODE_MATCH:
+                    accept = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+        std::sort(nodes.begin(), nodes.end());
+        return accept;
+    };
+
+    auto insert = [&](const uint8_t context) -> uint32_t
+    {
+        Key        key(context, nodes);
+        const auto found = indexes.find(key);
+        if(found != indexes.end()) {
+            return found->second;
+        }
+        const uint32_t index = static_cast<uint32_t>(subsets.size());
+        stack.assign(nodes.begin(), nodes.end());
+        final.push_back(closure(context, AT_TEXT | AT_LINE) ? 1 : 0);
+        indexes.emplace(key, index);
+        subsets.push_back(std::move(key));
+        return index;
+    };
+
+    /* the bytes that no set and no assertion tell apart share one class */
+    auto partition = [&]() -> void
+    {
+        uint8_t remap[512];
+        _classes = 1;
+        std::fill(_map, _map + 256, 0);
+        auto refine = [&](const ByteSet& set) -> void
+        {
+            uint32_t count = 0;
+            std::fill(remap, remap + 512, 0xff);
+            for(uint32_t byte = 0; byte < 256; ++byte) {
+                const uint32_t slot = (_map[byte] << 1) | (set.has(byte) ? 1 : 0);
+                if(remap[slot] == 0xff) {
+                    remap[slot] = static_cast<uint8_t>(count++);
+                }
+                _map[byte] = remap[slot];
+            }
+            _classes = count;
+        };
+        for(uint32_t index = 0; index < automaton.size(); ++index) {
+            const Automaton::Node& node(automaton.node(index));
+            if(node.type == Automaton::NODE_BYTE) {
+                refine(automaton.set(node.set));
+            }
+        }
+        if(automaton.multiline() != false) {
+            ByteSet newline;
+            newline.clear();
+            newline.add('\n');
+            refine(newline);
+        }
+        for(uint32_t byte = 256; byte-- > 0;) {
+            first[_map[byte]] = static_cast<uint8_t>(byte);
+        }
+    };
+
+    clear();
+    if(automaton.valid() == false) {
+        return false;
+    }
+    partition();
+    subsets.push_back(Key(0, std::vector<uint32_t>()));
+    subsets.push_back(Key(0, std::vector<uint32_t>()));
+    final.push_back(0);
+    final.push_back(1);
+    stack.assign(1, automaton.start());
+    if(closure(AT_TEXT | AT_LINE, 0) != false) {
+        start = STATE_MATCH;
+    }
+    else {
+        start = insert(AT_TEXT | AT_LINE);
+    }
+    /* the subset construction follows LazyDFA::next_state() for one byte of each class */
+    for(uint32_t index = 0; index < subsets.size(); ++index) {
+        if(subsets.size() > MAX_STATES) {
+            return false;
+        }
+        for(uint32_t klass = 0; klass < _classes; ++klass) {
+            const uint8_t byte = first[klass];
+            uint32_t      next = STATE_DEAD;
+            if(index <= STATE_MATCH) {
+                delta.push_back(index);
+                continue;
+            }
+            const uint8_t         context = (((byte == '\n') && automaton.multiline()) ? AT_LINE : 0);
+            std::vector<uint32_t> current(subsets[index].second);
+            if(context != 0) {
+                stack.assign(current.begin(), current.end());
+                if(closure(subsets[index].first, AT_LINE) != false) {
+                    next = STATE_MATCH;
+                }
+                current = nodes;
+            }
+            if(next != STATE_MATCH) {
+                stack.assign(1, automaton.start());
+                for(const uint32_t entry : current) {
+                    const Automaton::Node& node(automaton.node(entry));
+                    if((node.type == Automaton::NODE_BYTE) && automaton.set(node.set).has(byte)) {
+                        stack.push_back(node.out);
+                    }
+                }
+                if(closure(context, 0) != false) {
+                    next = STATE_MATCH;
+                }
+                else if((nodes.empty() == false) || automaton.multiline()) {
+                    next = insert(context);
+                }
+            }
+            delta.push_back(next);
+        }
+    }
+    const uint32_t built = static_cast<uint32_t>(subsets.size());
+    minimize(delta, final, start);
+    layout(delta, final, start);
+    _fingerprint = fingerprint(bytecode);
+    _valid       = true;
+    if(_loglevel >= LogLevel::LOG_DEBUG) {
+        _ostream << "🔵" << ' ' << "building<" << built << " states, " << _states << " minimal, " << _classes << " classes>" << std::endl;
+    }
+    return true;
+}
+
+auto FullDFA::minimize(std::vector<uint32_t>& delta, std::vector<uint8_t>& final, uint32_t& start) const -> void
+{
+    const uint32_t        count   = static_cast<uint32_t>(final.size());
+    const uint32_t        classes = _classes;
+    std::vector<uint32_t> heads((count + 1) * classes, 0);
+    std::vector<uint32_t> sources(count * classes, 0);
+    std::vector<uint32_t> elements(count);
+    std::vector<uint32_t> locations(count);
+    std::vector<uint32_t> blocks(count);
+    std::vector<uint32_t> begins;
+    std::vector<uint32_t> ends;
+    std::vector<uint32_t> marked;
+    std::vector<uint8_t>  pending;
+    std::vector<uint32_t> worklist;
+    std::vector<uint32_t> splitter;
+    std::vector<uint32_t> touched;
+
+    /* the predecessors of each state, grouped by class */
+    for(uint32_t state = 0; state < count; ++state) {
+        for(uint32_t klass = 0; klass < classes; ++klass) {
+            ++heads[(klass * (count + 1)) + delta[(state * classes) + klass] + 1];
+        }
+    }
+    for(uint32_t klass = 0; klass < classes; ++klass) {
+        uint32_t* head = heads.data() + (klass * (count + 1));
+        for(uint32_t state = 0; state < count; ++state) {
+            head[state + 1] += head[state];
+        }
+        for(uint32_t state = 0; state < count; ++state) {
+            const uint32_t target = delta[(state * classes) + klass];
+            sources[(klass * count) + head[target]++] = state;
+        }
+        for(uint32_t state = count; state > 0; --state) {
+            head[state] = head[state - 1];
+        }
+        head[0] = 0;
+    }
+
+    /* Hopcroft: start from the accepting and rejecting states and split by predecessors */
+    auto add_block = [&](const uint32_t begin, const uint32_t end) -> uint32_t
+    {
+        const uint32_t block = static_cast<uint32_t>(begins.size());
+        begins.push_back(begin);
+        ends.push_back(end);
+        marked.push_back(0);
+        pending.push_back(0);
+        for(uint32_t location = begin; location < end; ++location) {
+            blocks[elements[location]] = block;
+        }
+        return block;
+    };
+
+    auto push = [&](const uint32_t block) -> void
+    {
+        if(pending[block] == 0) {
+            pending[block] = 1;
+            worklist.push_back(block);
+        }
+    };
+
+    uint32_t accepting = 0;
+    for(uint32_t state = 0; state < count; ++state) {
+        if(final[state] != 0) {
+            elements[accepting++] = state;
+        }
+    }
+    uint32_t rejecting = accepting;
+    for(uint32_t state = 0; state < count; ++state) {
+        if(final[state] == 0) {
+            elements[rejecting++] = state;
+        }
+    }
+    for(uint32_t location = 0; location < count; ++location) {
+        locations[elements[location]] = location;
+    }
+    if(accepting != 0) {
+        push(add_block(0, accepting));
+    }
+    if(accepting != count) {
+        push(add_block(accepting, count));
+    }
+    while(worklist.empty() == false) {
+        const uint32_t block = worklist.back();
+        worklist.pop_back();
+        pending[block] = 0;
+        splitter.assign(elements.begin() + begins[block], elements.begin() + ends[block]);
+        for(uint32_t klass = 0; klass < classes; ++klass) {
+            const uint32_t* head = heads.data() + (klass * (count + 1));
+            const uint32_t* from = sources.data() + (klass * count);
+            touched.clear();
+            for(const uint32_t target : splitter) {
+                for(uint32_t entry = head[target]; entry < head[target + 1]; ++entry) {
+                    const uint32_t state = from[entry];
+                    const uint32_t owner = blocks[state];
+                    const uint32_t slot  = begins[owner] + marked[owner];
+                    const uint32_t other = elements[slot];
+                    if(marked[owner]++ == 0) {
+                        touched.push_back(owner);
+                    }
+                    elements[locations[state]] = other;
+                    locations[other] = locations[state];
+                    elements[slot] = state;
+                    locations[state] = slot;
+                }
+            }
+            for(const uint32_t owner : touched) {
+                const uint32_t split = begins[owner] + marked[owner];
+                marked[owner] = 0;
+                if(split == ends[owner]) {
+                    continue;
+                }
+                const uint32_t added = add_block(begins[owner], split);
+                begins[owner] = split;
+                if(pending[owner] != 0) {
+                    push(added);
+                }
+                else if((split - begins[added]) <= (ends[owner] - split)) {
+                    push(added);
+                }
+                else {
+                    push(owner);
+                }
+            }
+        }
+    }
+
+    /* renumber the blocks with the two sinks first, then rebuild the transitions */
+    const uint32_t        total = static_cast<uint32_t>(begins.size());
+    std::vector<uint32_t> renumber(total, ~static_cast<uint32_t>(0));
+    std::vector<uint32_t> members;
+    uint32_t              next = 0;
+    renumber[blocks[STATE_DEAD]]  = next++;
+    renumber[blocks[STATE_MATCH]] = next++;
+    members.push_back(static_cast<uint32_t>(STATE_DEAD));
+    members.push_back(static_cast<uint32_t>(STATE_MATCH));
+    for(uint32_t state = 0; state < count; ++state) {
+        if(renumber[blocks[state]] == ~static_cast<uint32_t>(0)) {
+            renumber[blocks[state]] = next++;
+            members.push_back(state);
+        }
+    }
+    std::vector<uint32_t> reduced(next * classes);
+    std::vector<uint8_t>  accepts(next);
+    for(uint32_t index = 0; index < next; ++index) {
+        const uint32_t state = members[index];
+        for(uint32_t klass = 0; klass < classes; ++klass) {
+            reduced[(index * classes) + klass] = renumber[blocks[delta[(state * classes) + klass]]];
+        }
+        accepts[index] = final[state];
+    }
+    start = renumber[blocks[start]];
+    delta.swap(reduced);
+    final.swap(accepts);
+}
+
+auto FullDFA::layout(const std::vector<uint32_t>& delta, const std::vector<uint8_t>& final, const uint32_t start) -> void
+{
+    const uint32_t count = static_cast<uint32_t>(final.size());
+
+    /* a row never straddles a cache line: short rows are padded to a power of two, long ones to whole lines */
+    _stride = 1;
+    while((_stride < _classes) && (_stride < ROW_ALIGN)) {
+        _stride <<= 1;
+    }
+    if(_stride < _classes) {
+        _stride = ((_classes + ROW_ALIGN - 1) / ROW_ALIGN) * ROW_ALIGN;
+    }
+    _states = count;
+    _final  = final;
+    _storage.assign((static_cast<size_t>(count) * _stride) + ROW_ALIGN, static_cast<uint32_t>(STATE_DEAD));
+    const uintptr_t address = reinterpret_cast<uintptr_t>(_storage.data());
+    const uintptr_t aligned = (address + (ROW_ALIGN * sizeof(uint32_t)) - 1) & ~static_cast<uintptr_t>((ROW_ALIGN * sizeof(uint32_t)) - 1);
+    _table = _storage.data() + ((aligned - address) / sizeof(uint32_t));
+    for(uint32_t state = 0; state < count; ++state) {
+        for(uint32_t klass = 0; klass < _classes; ++klass) {
+            _table[(state * _stride) + klass] = delta[(state * _classes) + klass] * _stride;
+        }
+    }
+    _start = start * _stride;
+}
+
+auto FullDFA::fingerprint(const ByteCode& bytecode) -> uint64_t
+{
+    const uint8_t* data = bytecode.data();
+    uint64_t       hash = 0xcbf29ce484222325ull;
+
+    for(size_t index = 0; index < bytecode.size(); ++index) {
+        hash = (hash ^ data[index]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+auto FullDFA::save(std::vector<uint8_t>& image) const -> void
+{
+    auto put = [&](const uint32_t value) -> void
+    {
+        image.push_back(static_cast<uint8_t>(value >>  0));
+        image.push_back(static_cast<uint8_t>(value >>  8));
+        image.push_back(static_cast<uint8_t>(value >> 16));
+        image.push_back(static_cast<uint8_t>(value >> 24));
+    };
+
+    /* the header, the class map, the accepting flags, then the rows with plain state numbers */
+    image.clear();
+    if(_valid == false) {
+        return;
+    }
+    put(MAGIC);
+    put(VERSION);
+    put(static_cast<uint32_t>(_fingerprint >>  0));
+    put(static_cast<uint32_t>(_fingerprint >> 32));
+    put(_classes);
+    put(_states);
+    put(_start / _stride);
+    image.insert(image.end(), _map, _map + 256);
+    image.insert(image.end(), _final.begin(), _final.end());
+    for(uint32_t state = 0; state < _states; ++state) {
+        for(uint32_t klass = 0; klass < _classes; ++klass) {
+            put(_table[(state * _stride) + klass] / _stride);
+        }
+    }
+}
+
+auto FullDFA::is_image(const uint8_t* data, const size_t size) -> bool
+{
+    /* only the magic is checked, the image may have been saved by another program or version */
+    return (size >= 4) && ((static_cast<uint32_t>(data[0]) <<  0)
+                         | (static_cast<uint32_t>(data[1]) <<  8)
+                         | (static_cast<uint32_t>(data[2]) << 16)
+                         | (static_cast<uint32_t>(data[3]) << 24)) == MAGIC;
+}
+
+auto FullDFA::load(const ByteCode& bytecode, const uint8_t* data, const size_t size) -> bool
+{
+    const uint8_t* curr = data;
+    const uint8_t* end  = data + size;
+
+    auto get = [&](uint32_t& value) -> bool
+    {
+        if((end - curr) < 4) {
+            return false;
+        }
+        value = (static_cast<uint32_t>(curr[0]) <<  0)
+              | (static_cast<uint32_t>(curr[1]) <<  8)
+              | (static_cast<uint32_t>(curr[2]) << 16)
+              | (static_cast<uint32_t>(curr[3]) << 24);
+        curr += 4;
+        return true;
+    };
+
+    auto do_load = [&]() -> bool
+    {
+        uint32_t magic   = 0;
+        uint32_t version = 0;
+        uint32_t lower   = 0;
+        uint32_t upper   = 0;
+        uint32_t classes = 0;
+        uint32_t states  = 0;
+        uint32_t start   = 0;
+        if(!get(magic) || !get(version) || !get(lower) || !get(upper) || !get(classes) || !get(states) || !get(start)) {
+            return false;
+        }
+        if((magic != MAGIC) || (version != VERSION)) {
+            return false;
+        }
+        if(((static_cast<uint64_t>(upper) << 32) | lower) != fingerprint(bytecode)) {
+            return false;
+        }
+        if((classes == 0) || (classes > 256) || (states <= STATE_MATCH) || (states > MAX_STATES) || (start >= states)) {
+            return false;
+        }
+        if(static_cast<size_t>(end - curr) != (256 + states + (static_cast<size_t>(states) * classes * 4))) {
+            return false;
+        }
+        std::vector<uint32_t> delta(static_cast<size_t>(states) * classes);
+        std::vector<uint8_t>  final(curr + 256, curr + 256 + states);
+        std::copy(curr, curr + 256, _map);
+        curr += 256 + states;
+        for(auto& target : delta) {
+            if((get(target) == false) || (target >= states)) {
+                return false;
+            }
+        }
+        for(uint32_t byte = 0; byte < 256; ++byte) {
+            if(_map[byte] >= classes) {
+                return false;
+            }
+        }
+        _classes = classes;
+        layout(delta, final, start);
+        _fingerprint = fingerprint(bytecode);
+        return true;
+    };
+
+    clear();
+    if(do_load() == false) {
+        clear();
+        return false;
+    }
+    return (_valid = true);
+}
+
+auto FullDFA::execute(const char* data, const size_t size) -> bool
+{
+    if(_loglevel >= LogLevel::LOG_PRINT) {
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        _ostream.write(data, size);
+        _ostream << '>' << std::endl;
+    }
+    if(search(data, size) != false) {
+        if(_loglevel >= LogLevel::LOG_ALERT) {
+            _ostream << "🟢" << ' ' << "the string matches the regular expression" << std::endl;
+        }
+        return true;
+    }
+    if(_loglevel >= LogLevel::LOG_ERROR) {
+        _ostream << "🔴" << ' ' << "the string does not match the regular expression" << std::endl;
+    }
+    return false;
+}
+
+auto FullDFA::scan(const char* data, const size_t size) -> bool
+{
+    return search(data, size);
+}
+
+auto FullDFA::execute_chain(const Input* segments, const size_t count) -> bool
+{
+    uint32_t state    = _start;
+    size_t   position = 0;
+
+    if(_loglevel >= LogLevel::LOG_PRINT) {
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        for(size_t index = 0; index < count; ++index) {
+            _ostream.write(segments[index].data, segments[index].size);
+        }
+        _ostream << '>' << std::endl;
+    }
+    /* the state carries over from one segment to the next, only the last one sees the end of the text */
+    for(size_t index = 0; index < count; ++index) {
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(segments[index].data);
+        const uint8_t* curr  = begin;
+        state     = advance(state, curr, begin + segments[index].size);
+        position += (curr - begin);
+        if(state <= (STATE_MATCH * _stride)) {
+            break;
+        }
+    }
+    _position = position;
+    _stats.count_bytes(_position);
+    _stats.count_dfa_states(_states);
+    if(_final[state / _stride] != 0) {
+        if(_loglevel >= LogLevel::LOG_ALERT) {
+            _ostream << "🟢" << ' ' << "the string matches the regular expression" << std::endl;
+        }
+        return true;
+    }
+    if(_loglevel >= LogLevel::LOG_ERROR) {
+        _ostream << "🔴" << ' ' << "the string does not match the regular expression" << std::endl;
+    }
+    return false;
+}
+
+auto FullDFA::search(const char* data, const size_t size) -> bool
+{
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* curr  = begin;
+    const uint32_t state = advance(_start, curr, begin + size);
+
+    _position = curr - begin;
+    _stats.count_bytes(_position);
+    _stats.count_dfa_states(_states);
+
+    return _final[state / _stride] != 0;
+}
+
+auto FullDFA::advance(uint32_t state, const uint8_t*& curr, const uint8_t* end) const -> uint32_t
+{
+    const uint8_t*  map   = _map;
+    const uint32_t* table = _table;
+    const uint32_t  sink  = STATE_MATCH * _stride;
+
+    /* both sinks are below every other premultiplied state */
+    if(state > sink) {
+        while(curr != end) {
+            state = table[state + map[*curr++]];
+            if(state <= sink) {
+                break;
+            }
+        }
+    }
+    return state;
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+/*
+ * fulldfa.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __FullDFA_h__
+#define __FullDFA_h__
+
+#include "bytecode.h"
+#include "automaton.h"
+#include "stats.h"
+
+// ---------------------------------------------------------------------------
+// FullDFA: a minimal DFA built ahead of time from the automaton
+// ---------------------------------------------------------------------------
+
+class FullDFA
+{
+public: // public interface
+    FullDFA(Stats& stats, OStream& ostream, const uint32_t loglevel);
+
+    FullDFA(FullDFA&&) = delete;
+
+    FullDFA(const FullDFA&) = delete;
+
+    FullDFA& operator=(FullDFA&&) = delete;
+
+    FullDFA& operator=(const FullDFA&) = delete;
+
+    virtual ~FullDFA() = default;
+
+    static constexpr uint32_t MAX_STATES = 4096; // the build gives up past this count
+    static constexpr uint32_t ROW_ALIGN  = 16;   // transitions per cache line
+    static constexpr uint32_t MAGIC      = 0x41464450; // "PDFA" in little endian
+    static constexpr uint32_t VERSION    = 1;
+
+    static constexpr uint32_t STATE_DEAD  = 0; // no match is possible
+    static constexpr uint32_t STATE_MATCH = 1; // a match has been found
+
+    static constexpr uint8_t AT_TEXT = 0x01; // at the start or the end of the text
+    static constexpr uint8_t AT_LINE = 0x02; // at the start or the end of a line
+
+    static auto is_image(const uint8_t* data, const size_t size) -> bool;
+
+    auto clear() -> void;
+
+    auto build(const ByteCode& bytecode, const Automaton& automaton) -> bool;
+
+    auto save(std::vector<uint8_t>& image) const -> void;
+
+    auto load(const ByteCode& bytecode, const uint8_t* data, const size_t size) -> bool;
+
+    auto execute(const char* data, const size_t size) -> bool;
+
+    auto scan(const char* data, const size_t size) -> bool;
+
+    auto execute_chain(const Input* segments, const size_t count) -> bool;
+
+    auto valid() const -> bool
+    {
+        return _valid;
+    }
+
+    auto states() const -> uint32_t
+    {
+        return _states;
+    }
+
+    auto classes() const -> uint32_t
+    {
+        return _classes;
+    }
+
+    auto position() const -> size_t
+    {
+        return _position;
+    }
+
+    auto bytes_reserved() const -> size_t;
+
+protected: // protected interface
+    auto search(const char* data, const size_t size) -> bool;
+
+    auto advance(uint32_t state, const uint8_t*& curr, const uint8_t* end) const -> uint32_t;
+
+    auto layout(const std::vector<uint32_t>& delta, const std::vector<uint8_t>& final, const uint32_t start) -> void;
+
+    auto minimize(std::vector<uint32_t>& delta, std::vector<uint8_t>& final, uint32_t& start) const -> void;
+
+    static auto fingerprint(const ByteCode& bytecode) -> uint64_t;
+
+protected: // protected data
+    OStream&              _ostream;
+    const uint32_t        _loglevel;
+    Stats&                _stats;
+    uint8_t               _map[256];
+    std::vector<uint8_t>  _final;
+    std::vector<uint32_t> _storage;
+    uint32_t*             _table;
+    uint64_t              _fingerprint;
+    uint32_t              _classes;
+    uint32_t              _stride;
+    uint32_t              _states;
+    uint32_t              _start;
+    size_t                _position;
+    bool                  _valid;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __FullDFA_h__ */
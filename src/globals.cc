@@ -40,7 +40,19 @@
 std::string Globals::arg0     = "pico-regex";
 std::string Globals::arg1     = "";
 std::string Globals::arg2     = "";
+std::string Globals::dfa_file = "";
 uint32_t    Globals::loglevel = 3;
+uint32_t    Globals::engine   = 2;
+uint32_t    Globals::format   = 0;
+uint32_t    Globals::io       = 0;
+uint32_t    Globals::threads  = 0;
+uint32_t    Globals::segments = 0;
+uint32_t    Globals::flags    = 0;
+bool        Globals::stats    = false;
+bool        Globals::batch    = false;
+bool        Globals::count    = false;
+bool        Globals::recursive = false;
+int         Globals::argn     = 0;
 int         Globals::exitcode = EXIT_SUCCESS;
 
 // ---------------------------------------------------------------------------
@@ -26,7 +26,19 @@ struct Globals
     static std::string arg0;
     static std::string arg1;
     static std::string arg2;
+    static std::string dfa_file;
     static uint32_t    loglevel;
+    static uint32_t    engine;
+    static uint32_t    format;
+    static uint32_t    io;
+    static uint32_t    threads;
+    static uint32_t    segments;
+    static uint32_t    flags;
+    static bool        stats;
+    static bool        batch;
+    static bool        count;
+    static bool        recursive;
+    static int         argn;
     static int         exitcode;
 };
 
@@ -0,0 +1,524 @@
+/*
+ * lazydfa.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include "lazydfa.h"
+
+// ---------------------------------------------------------------------------
+// LazyDFA
+// ---------------------------------------------------------------------------
+
+LazyDFA::LazyDFA(const Automaton& automaton, Stats& stats, OStream& ostream, const uint32_t loglevel)
+    : _ostream(ostream)
+    , _loglevel(loglevel)
+    , _automaton(automaton)
+    , _stats(stats)
+    , _scratch(nullptr)
+    , _states()
+    , _pool()
+    , _buckets()
+    , _table()
+    , _epoch(0)
+    , _start(STATE_UNKNOWN)
+    , _pinned(nullptr)
+    , _pinned_count(0)
+    , _position(0)
+{
+}
+
+auto LazyDFA::reset() -> void
+{
+    _states.clear();
+    _pool.clear();
+    _table.clear();
+    _buckets.clear();
+    _start = STATE_UNKNOWN;
+}
+
+auto LazyDFA::bytes_reserved() const -> size_t
+{
+    return (_states.capacity()  * sizeof(State))
+         + (_pool.capacity()    * sizeof(uint32_t))
+         + (_buckets.capacity() * sizeof(int32_t))
+         + (_table.capacity()   * sizeof(int32_t));
+}
+
+auto LazyDFA::prepare(MatchScratch& scratch) -> void
+{
+    _scratch = &scratch;
+    _scratch->reserve(_automaton);
+    if(_buckets.size() != MAX_BUCKETS) {
+        _buckets.assign(MAX_BUCKETS, -1);
+    }
+}
+
+auto LazyDFA::begin(const char* data, const size_t size, MatchScratch& scratch) -> void
+{
+    prepare(scratch);
+    if(_loglevel >= LogLevel::LOG_PRINT) {
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        _ostream.write(data, size);
+        _ostream << '>' << std::endl;
+    }
+}
+
+auto LazyDFA::success() -> bool
+{
+    if(_loglevel >= LogLevel::LOG_ALERT) {
+        _ostream << "🟢" << ' ' << "the string matches the regular expression" << std::endl;
+    }
+    return true;
+}
+
+auto LazyDFA::failure() -> bool
+{
+    if(_loglevel >= LogLevel::LOG_ERROR) {
+        _ostream << "🔴" << ' ' << "the string does not match the regular expression" << std::endl;
+    }
+    return false;
+}
+
+auto LazyDFA::closure(const uint8_t before, const uint8_t after) -> bool
+{
+    std::vector<uint32_t>& marks(_scratch->marks);
+    std::vector<uint32_t>& stack(_scratch->stack);
+    std::vector<uint32_t>& nodes(_scratch->nodes);
+    const uint32_t         generation = _scratch->next_generation();
+    bool                   accept     = false;
+
+    nodes.clear();
+    while(stack.empty() == false) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        if(marks[index] == generation) {
+            continue;
+        }
+        marks[index] = generation;
+        const Automaton::Node& node(_automaton.node(index));
+        switch(node.type) {
+            case Automaton::NODE_BYTE:
+                nodes.push_back(index);
+                break;
+            case Automaton::NODE_SPLIT:
+                stack.push_back(node.alt);
+                stack.push_back(node.out);
+                break;
+            case Automaton::NODE_STX:
+                if((before & AT_TEXT) != 0) {
+                    stack.push_back(node.out);
+                }
+                break;
+            case Automaton::NODE_ETX:
+                if((after & AT_TEXT) != 0) {
+                    stack.push_back(node.out);
+                }
+                else {
+                    nodes.push_back(index);
+                }
+                break;
+            case Automaton::NODE_BOL:
+                if((before & AT_LINE) != 0) {
+                    stack.push_back(node.out);
+                }
+                break;
+            case Automaton::NODE_EOL:
+                if((after & AT_LINE) != 0) {
+                    stack.push_back(node.out);
+                }
+                else {
+                    nodes.push_back(index);
+                }
+                break;
+            case Automaton::NODE_MATCH:
+                accept = true;
+                break;
+            default:
+                break;
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+
+    return accept;
+}
+
+auto LazyDFA::lookup(const uint32_t* nodes, const uint32_t count, const uint32_t hash, const uint8_t context) const -> int32_t
+{
+    for(size_t bucket = (hash & (MAX_BUCKETS - 1)); _buckets[bucket] >= 0; bucket = ((bucket + 1) & (MAX_BUCKETS - 1))) {
+        const State& state(_states[_buckets[bucket]]);
+        if((state.hash  == hash)
+        && (state.count == count)
+        && (state.context == context)
+        && (std::equal(nodes, nodes + count, _pool.data() + state.offset) != false)) {
+            return _buckets[bucket] << 8;
+        }
+    }
+    return STATE_UNKNOWN;
+}
+
+auto LazyDFA::add_state(const uint32_t* nodes, const uint32_t count, const uint32_t hash, const uint8_t context, const bool final) -> int32_t
+{
+    const int32_t index = static_cast<int32_t>(_states.size());
+    size_t        bucket = (hash & (MAX_BUCKETS - 1));
+
+    while(_buckets[bucket] >= 0) {
+        bucket = ((bucket + 1) & (MAX_BUCKETS - 1));
+    }
+    _buckets[bucket] = index;
+    _states.push_back(State { static_cast<uint32_t>(_pool.size()), count, hash, context, final });
+    _pool.insert(_pool.end(), nodes, nodes + count);
+    _table.resize(_table.size() + 256, static_cast<int32_t>(STATE_UNKNOWN));
+
+    return index << 8;
+}
+
+auto LazyDFA::insert(const uint8_t context) -> int32_t
+{
+    std::vector<uint32_t>& nodes(_scratch->nodes);
+    const uint32_t         count = static_cast<uint32_t>(nodes.size());
+    uint32_t               hash  = (0x7f4a7c15u + (context * 0x9e3779b9u));
+
+    for(const uint32_t node : nodes) {
+        hash = (hash ^ node) * 0x01000193u;
+    }
+    const int32_t found = lookup(nodes.data(), count, hash, context);
+    if(found >= 0) {
+        return found;
+    }
+    if((_states.size() >= MAX_STATES) || ((_pool.size() + count) > MAX_POOL)) {
+        flush();
+    }
+    const int32_t  row   = add_state(nodes.data(), count, hash, context, false);
+    const uint32_t first = _states[row >> 8].offset;
+    _scratch->stack.assign(_pool.begin() + first, _pool.begin() + first + count);
+    _states[row >> 8].final = closure(context, AT_TEXT | AT_LINE);
+
+    return row;
+}
+
+auto LazyDFA::flush() -> void
+{
+    std::vector<uint32_t>& spill(_scratch->spill);
+    State                  pinned[MAX_LANES];
+
+    spill.clear();
+    for(size_t lane = 0; lane < _pinned_count; ++lane) {
+        if(_pinned[lane] >= 0) {
+            const State& state(_states[_pinned[lane] >> 8]);
+            pinned[lane] = state;
+            pinned[lane].offset = static_cast<uint32_t>(spill.size());
+            spill.insert(spill.end(), _pool.begin() + state.offset, _pool.begin() + state.offset + state.count);
+        }
+    }
+    _states.clear();
+    _pool.clear();
+    _table.clear();
+    std::fill(_buckets.begin(), _buckets.end(), -1);
+    _start = STATE_UNKNOWN;
+    _epoch += 1;
+    _stats.count_dfa_flush();
+    for(size_t lane = 0; lane < _pinned_count; ++lane) {
+        if(_pinned[lane] >= 0) {
+            const State& state(pinned[lane]);
+            const int32_t found = lookup(spill.data() + state.offset, state.count, state.hash, state.context);
+            if(found >= 0) {
+                _pinned[lane] = found;
+            }
+            else {
+                _pinned[lane] = add_state(spill.data() + state.offset, state.count, state.hash, state.context, state.final);
+            }
+        }
+    }
+}
+
+auto LazyDFA::start_state() -> int32_t
+{
+    if(_start == STATE_UNKNOWN) {
+        _scratch->stack.assign(1, _automaton.start());
+        if(closure(AT_TEXT | AT_LINE, 0) != false) {
+            _start = STATE_MATCH;
+        }
+        else {
+            _start = insert(AT_TEXT | AT_LINE);
+        }
+    }
+    return _start;
+}
+
+auto LazyDFA::next_state(const int32_t state, const uint8_t byte) -> int32_t
+{
+    std::vector<uint32_t>& stack(_scratch->stack);
+    const State&           current(_states[state >> 8]);
+    const uint32_t*        nodes   = _pool.data() + current.offset;
+    uint32_t               count   = current.count;
+    const uint8_t          context = (((byte == '\n') && _automaton.multiline()) ? AT_LINE : 0);
+    const uint64_t         epoch   = _epoch;
+    int32_t                next    = STATE_DEAD;
+
+    if(context != 0) {
+        /* the pending end of line assertions hold right before a newline */
+        stack.assign(nodes, nodes + count);
+        if(closure(current.context, AT_LINE) != false) {
+            next = STATE_MATCH;
+        }
+        nodes = _scratch->nodes.data();
+        count = static_cast<uint32_t>(_scratch->nodes.size());
+    }
+    if(next != STATE_MATCH) {
+        stack.assign(1, _automaton.start());
+        for(; count != 0; --count) {
+            const Automaton::Node& node(_automaton.node(*nodes++));
+            if((node.type == Automaton::NODE_BYTE) && _automaton.set(node.set).has(byte)) {
+                stack.push_back(node.out);
+            }
+        }
+        if(closure(context, 0) != false) {
+            next = STATE_MATCH;
+        }
+        else if((_scratch->nodes.empty() == false) || _automaton.multiline()) {
+            /* a start of line assertion may still hold after the next newline */
+            next = insert(context);
+        }
+    }
+    if(epoch == _epoch) {
+        _table[state + byte] = next;
+    }
+    return next;
+}
+
+auto LazyDFA::execute(const char* data, const size_t size, MatchScratch& scratch) -> bool
+{
+    begin(data, size, scratch);
+    if(_automaton.rejects(size) != false) {
+        return failure();
+    }
+    if(search(data, size) != false) {
+        return success();
+    }
+    return failure();
+}
+
+auto LazyDFA::scan(const char* data, const size_t size, MatchScratch& scratch) -> bool
+{
+    prepare(scratch);
+    return search(data, size);
+}
+
+auto LazyDFA::search(const char* data, const size_t size) -> bool
+{
+    const uint8_t* curr  = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end   = curr + size;
+    int32_t        state = start_state();
+
+    if(state >= 0) {
+        state = advance(state, curr, end);
+    }
+    _position = size - (end - curr);
+    _stats.count_bytes(_position);
+    _stats.count_dfa_states(_states.size());
+
+    return accepts(state);
+}
+
+auto LazyDFA::advance(int32_t state, const uint8_t*& curr, const uint8_t* end) -> int32_t
+{
+    while(curr != end) {
+        const uint8_t byte = *curr++;
+        int32_t       next = _table[state + byte];
+        if(next < 0) {
+            if(next == STATE_UNKNOWN) {
+                next = next_state(state, byte);
+            }
+            if(next < 0) {
+                return next;
+            }
+        }
+        state = next;
+    }
+    return state;
+}
+
+auto LazyDFA::accepts(const int32_t state) const -> bool
+{
+    if(state == STATE_MATCH) {
+        return true;
+    }
+    if(state == STATE_DEAD) {
+        return false;
+    }
+    return _states[state >> 8].final;
+}
+
+auto LazyDFA::execute_batch(const Input* inputs, const size_t count, uint64_t* results, MatchScratch& scratch) -> size_t
+{
+    int32_t        states[MAX_LANES];
+    const uint8_t* currs[MAX_LANES];
+    const uint8_t* ends[MAX_LANES];
+    size_t         indexes[MAX_LANES];
+    size_t         next_input = 0;
+    size_t         active     = 0;
+    size_t         matched    = 0;
+
+    auto finish = [&](const size_t index, const bool status) -> void
+    {
+        if(status != false) {
+            results[index >> 6] |= (static_cast<uint64_t>(1) << (index & 63));
+            ++matched;
+        }
+    };
+
+    auto load = [&](const size_t lane) -> void
+    {
+        states[lane] = STATE_DEAD;
+        while(next_input < count) {
+            const size_t   index = next_input++;
+            const Input&   input(inputs[index]);
+            const int32_t  state = start_state();
+            if(_automaton.rejects(input.size) != false) {
+                finish(index, false);
+                continue;
+            }
+            _stats.count_bytes(input.size);
+            if(state < 0) {
+                finish(index, state == STATE_MATCH);
+            }
+            else if(input.size == 0) {
+                finish(index, _states[state >> 8].final);
+            }
+            else {
+                states[lane]  = state;
+                currs[lane]   = reinterpret_cast<const uint8_t*>(input.data);
+                ends[lane]    = currs[lane] + input.size;
+                indexes[lane] = index;
+                ++active;
+                return;
+            }
+        }
+    };
+
+    auto retire = [&](const size_t lane, const bool status) -> void
+    {
+        finish(indexes[lane], status);
+        --active;
+        load(lane);
+    };
+
+    _scratch = &scratch;
+    _scratch->reserve(_automaton);
+    if(_buckets.size() != MAX_BUCKETS) {
+        _buckets.assign(MAX_BUCKETS, -1);
+    }
+    _pinned       = states;
+    _pinned_count = MAX_LANES;
+    for(size_t word = 0; word < ((count + 63) >> 6); ++word) {
+        results[word] = 0;
+    }
+    for(size_t lane = 0; lane < MAX_LANES; ++lane) {
+        states[lane] = STATE_DEAD;
+    }
+    for(size_t lane = 0; lane < MAX_LANES; ++lane) {
+        load(lane);
+    }
+    while(active != 0) {
+        for(size_t lane = 0; lane < MAX_LANES; ++lane) {
+            const int32_t state = states[lane];
+            if(state < 0) {
+                continue;
+            }
+            if(currs[lane] == ends[lane]) {
+                retire(lane, _states[state >> 8].final);
+                continue;
+            }
+            const uint8_t byte = *currs[lane]++;
+            int32_t       next = _table[state + byte];
+            if(next == STATE_UNKNOWN) {
+                next = next_state(states[lane], byte);
+            }
+            if(next < 0) {
+                retire(lane, next == STATE_MATCH);
+                continue;
+            }
+            states[lane] = next;
+        }
+    }
+    _pinned       = nullptr;
+    _pinned_count = 0;
+    _stats.count_dfa_states(_states.size());
+
+    return matched;
+}
+
+auto LazyDFA::execute_chain(const Input* segments, const size_t count, MatchScratch& scratch) -> bool
+{
+    size_t  size     = 0;
+    size_t  position = 0;
+    int32_t state    = STATE_DEAD;
+
+    for(size_t index = 0; index < count; ++index) {
+        size += segments[index].size;
+    }
+    prepare(scratch);
+    if(_loglevel >= LogLevel::LOG_PRINT) {
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        for(size_t index = 0; index < count; ++index) {
+            _ostream.write(segments[index].data, segments[index].size);
+        }
+        _ostream << '>' << std::endl;
+    }
+    if(_automaton.rejects(size) != false) {
+        return failure();
+    }
+    /* the state carries over from one segment to the next, only the first and the last ones see the text boundaries */
+    if((state = start_state()) >= 0) {
+        for(size_t index = 0; index < count; ++index) {
+            const uint8_t* begin = reinterpret_cast<const uint8_t*>(segments[index].data);
+            const uint8_t* curr  = begin;
+            state     = advance(state, curr, begin + segments[index].size);
+            position += (curr - begin);
+            if(state < 0) {
+                break;
+            }
+        }
+    }
+    _position = position;
+    _stats.count_bytes(_position);
+    _stats.count_dfa_states(_states.size());
+    if(accepts(state) != false) {
+        return success();
+    }
+    return failure();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,132 @@
+/*
+ * lazydfa.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __LazyDFA_h__
+#define __LazyDFA_h__
+
+#include "bytecode.h"
+#include "automaton.h"
+#include "scratch.h"
+#include "stats.h"
+
+// ---------------------------------------------------------------------------
+// LazyDFA: a DFA built on demand from the automaton, one state at a time
+// ---------------------------------------------------------------------------
+
+class LazyDFA
+{
+public: // public interface
+    LazyDFA(const Automaton& automaton, Stats& stats, OStream& ostream, const uint32_t loglevel);
+
+    LazyDFA(LazyDFA&&) = delete;
+
+    LazyDFA(const LazyDFA&) = delete;
+
+    LazyDFA& operator=(LazyDFA&&) = delete;
+
+    LazyDFA& operator=(const LazyDFA&) = delete;
+
+    virtual ~LazyDFA() = default;
+
+    static constexpr int32_t STATE_UNKNOWN = -1; // transition not computed yet
+    static constexpr int32_t STATE_MATCH   = -2; // a match has been found
+    static constexpr int32_t STATE_DEAD    = -3; // no match is possible
+
+    static constexpr size_t MAX_STATES  = 4096;
+    static constexpr size_t MAX_BUCKETS = 2 * MAX_STATES;
+    static constexpr size_t MAX_POOL    = 1 << 20; // node slots shared by the states
+    static constexpr size_t MAX_LANES   = 8;
+
+    static constexpr uint8_t AT_TEXT = 0x01; // at the start or the end of the text
+    static constexpr uint8_t AT_LINE = 0x02; // at the start or the end of a line
+
+    auto reset() -> void;
+
+    auto execute(const char* data, const size_t size, MatchScratch& scratch) -> bool;
+
+    auto scan(const char* data, const size_t size, MatchScratch& scratch) -> bool;
+
+    auto execute_batch(const Input* inputs, const size_t count, uint64_t* results, MatchScratch& scratch) -> size_t;
+
+    auto execute_chain(const Input* segments, const size_t count, MatchScratch& scratch) -> bool;
+
+    auto bytes_reserved() const -> size_t;
+
+    auto position() const -> size_t
+    {
+        return _position;
+    }
+
+protected: // protected interface
+    struct State
+    {
+        uint32_t offset; // first node in the pool
+        uint32_t count;  // number of nodes
+        uint32_t hash;
+        uint8_t  context; // assertions holding before the first byte
+        bool     final;
+    };
+
+    auto prepare(MatchScratch& scratch) -> void;
+
+    auto begin(const char* data, const size_t size, MatchScratch& scratch) -> void;
+
+    auto success() -> bool;
+
+    auto failure() -> bool;
+
+    auto search(const char* data, const size_t size) -> bool;
+
+    auto advance(int32_t state, const uint8_t*& curr, const uint8_t* end) -> int32_t;
+
+    auto accepts(const int32_t state) const -> bool;
+
+    auto closure(const uint8_t before, const uint8_t after) -> bool;
+
+    auto lookup(const uint32_t* nodes, const uint32_t count, const uint32_t hash, const uint8_t context) const -> int32_t;
+
+    auto add_state(const uint32_t* nodes, const uint32_t count, const uint32_t hash, const uint8_t context, const bool final) -> int32_t;
+
+    auto insert(const uint8_t context) -> int32_t;
+
+    auto flush() -> void;
+
+    auto start_state() -> int32_t;
+
+    auto next_state(const int32_t state, const uint8_t byte) -> int32_t;
+
+protected: // protected data
+    OStream&              _ostream;
+    const uint32_t        _loglevel;
+    const Automaton&      _automaton;
+    Stats&                _stats;
+    MatchScratch*         _scratch;
+    std::vector<State>    _states;
+    std::vector<uint32_t> _pool;
+    std::vector<int32_t>  _buckets;
+    std::vector<int32_t>  _table;
+    uint64_t              _epoch;
+    int32_t               _start;
+    int32_t*              _pinned;
+    size_t                _pinned_count;
+    size_t                _position;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __LazyDFA_h__ */
@@ -37,6 +37,23 @@
 // LogLevel
 // ---------------------------------------------------------------------------
 
+auto LogLevel::null_stream() -> OStream&
+{
+    struct NullBuffer final
+        : public std::streambuf
+    {
+        auto overflow(int c) -> int override
+        {
+            return c;
+        }
+    };
+
+    static NullBuffer null_buffer;
+    static OStream    null_stream(&null_buffer);
+
+    return null_stream;
+}
+
 // ---------------------------------------------------------------------------
 // End-Of-File
 // ---------------------------------------------------------------------------
@@ -36,6 +36,30 @@ struct LogLevel
     static constexpr uint32_t LOG_PRINT = 3;
     static constexpr uint32_t LOG_DEBUG = 4;
     static constexpr uint32_t LOG_TRACE = 5;
+
+    static auto null_stream() -> OStream&; // discards whatever is written to it
+};
+
+// ---------------------------------------------------------------------------
+// ENABLE_TRACE
+// ---------------------------------------------------------------------------
+
+#ifndef ENABLE_TRACE
+#define ENABLE_TRACE 1
+#endif
+
+// ---------------------------------------------------------------------------
+// tracing policies
+// ---------------------------------------------------------------------------
+
+struct TraceOff
+{
+    static constexpr bool enabled = false;
+};
+
+struct TraceOn
+{
+    static constexpr bool enabled = (ENABLE_TRACE != 0);
 };
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,213 @@
+/*
+ * perfcounters.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "perfcounters.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::perf
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct perf
+{
+#ifdef __linux__
+    static auto open(const uint64_t config) -> int
+    {
+        struct perf_event_attr attr;
+
+        ::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+
+        return static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static auto close(const int fd) -> void
+    {
+        if(fd >= 0) {
+            static_cast<void>(::close(fd));
+        }
+    }
+
+    static auto reset(const int fd) -> void
+    {
+        if(fd >= 0) {
+            static_cast<void>(::ioctl(fd, PERF_EVENT_IOC_RESET, 0));
+        }
+    }
+
+    static auto enable(const int fd) -> void
+    {
+        if(fd >= 0) {
+            static_cast<void>(::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0));
+        }
+    }
+
+    static auto disable(const int fd) -> void
+    {
+        if(fd >= 0) {
+            static_cast<void>(::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0));
+        }
+    }
+
+    static auto read(const int fd) -> uint64_t
+    {
+        uint64_t value = 0;
+        if(fd >= 0) {
+            if(::read(fd, &value, sizeof(value)) != sizeof(value)) {
+                value = 0;
+            }
+        }
+        return value;
+    }
+#else
+    static auto open(const uint64_t config) -> int
+    {
+        return -1;
+    }
+
+    static auto close(const int fd) -> void
+    {
+    }
+
+    static auto reset(const int fd) -> void
+    {
+    }
+
+    static auto enable(const int fd) -> void
+    {
+    }
+
+    static auto disable(const int fd) -> void
+    {
+    }
+
+    static auto read(const int fd) -> uint64_t
+    {
+        return 0;
+    }
+#endif
+};
+
+}
+
+// ---------------------------------------------------------------------------
+// PerfCounters
+// ---------------------------------------------------------------------------
+
+PerfCounters::PerfCounters()
+    : _available(false)
+    , _fds{-1, -1, -1, -1}
+    , _values{0, 0, 0, 0}
+{
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+auto PerfCounters::open() -> bool
+{
+#ifdef __linux__
+    static const uint64_t configs[CNT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+#else
+    static const uint64_t configs[CNT_COUNT] = {
+        0, 0, 0, 0
+    };
+#endif
+
+    close();
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        if((_fds[counter] = perf::open(configs[counter])) >= 0) {
+            _available = true;
+        }
+    }
+    return _available;
+}
+
+auto PerfCounters::close() -> void
+{
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        perf::close(_fds[counter]);
+        _fds[counter] = -1;
+    }
+    _available = false;
+}
+
+auto PerfCounters::reset() -> void
+{
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        _values[counter] = 0;
+    }
+}
+
+auto PerfCounters::start() -> void
+{
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        perf::reset(_fds[counter]);
+    }
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        perf::enable(_fds[counter]);
+    }
+}
+
+auto PerfCounters::stop() -> void
+{
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        perf::disable(_fds[counter]);
+    }
+    for(int counter = 0; counter < CNT_COUNT; ++counter) {
+        _values[counter] += perf::read(_fds[counter]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
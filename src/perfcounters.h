@@ -0,0 +1,80 @@
+/*
+ * perfcounters.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __PerfCounters_h__
+#define __PerfCounters_h__
+
+// ---------------------------------------------------------------------------
+// PerfCounters
+// ---------------------------------------------------------------------------
+
+class PerfCounters
+{
+public: // public interface
+    PerfCounters();
+
+    PerfCounters(PerfCounters&&) = delete;
+
+    PerfCounters(const PerfCounters&) = delete;
+
+    PerfCounters& operator=(PerfCounters&&) = delete;
+
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    virtual ~PerfCounters();
+
+    static constexpr int CNT_CYCLES        = 0; // cpu cycles
+    static constexpr int CNT_INSTRUCTIONS  = 1; // retired instructions
+    static constexpr int CNT_BRANCHES      = 2; // retired branches
+    static constexpr int CNT_BRANCH_MISSES = 3; // mispredicted branches
+    static constexpr int CNT_COUNT         = 4; // number of counters
+
+    auto open() -> bool;
+
+    auto close() -> void;
+
+    auto reset() -> void;
+
+    auto start() -> void;
+
+    auto stop() -> void;
+
+    auto available() const -> bool
+    {
+        return _available;
+    }
+
+    auto valid(const int counter) const -> bool
+    {
+        return _fds[counter] >= 0;
+    }
+
+    auto value(const int counter) const -> uint64_t
+    {
+        return _values[counter];
+    }
+
+protected: // protected data
+    bool     _available;
+    int      _fds[CNT_COUNT];
+    uint64_t _values[CNT_COUNT];
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __PerfCounters_h__ */
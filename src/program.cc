@@ -30,10 +30,17 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <fstream>
+#include <algorithm>
 #include <stdexcept>
+#include <unistd.h>
 #include "globals.h"
 #include "program.h"
 #include "regexp.h"
+#include "source.h"
+#include "reader.h"
+#include "walker.h"
+#include "batch.h"
 
 // ---------------------------------------------------------------------------
 // Program
@@ -81,6 +88,48 @@ auto Program::init(const ArgList& args) -> bool
             else if((arg == "-5") || (arg == "--trace")) {
                 Globals::loglevel = LogLevel::LOG_TRACE;
             }
+            else if((arg == "-i") || (arg == "--ignore-case")) {
+                Globals::flags |= CompileFlags::FLAG_ICASE;
+            }
+            else if((arg == "-u") || (arg == "--utf8")) {
+                Globals::flags |= CompileFlags::FLAG_UTF8;
+            }
+            else if((arg == "-m") || (arg == "--multiline")) {
+                Globals::flags |= CompileFlags::FLAG_MULTILINE;
+            }
+            else if((arg == "-c") || (arg == "--count")) {
+                Globals::flags |= CompileFlags::FLAG_MULTILINE;
+                Globals::count  = true;
+            }
+            else if((arg == "-r") || (arg == "--recursive")) {
+                Globals::flags    |= CompileFlags::FLAG_MULTILINE;
+                Globals::recursive = true;
+            }
+            else if(arg.compare(0, 11, "--segments=") == 0) {
+                Globals::segments = std::max(0, std::atoi(arg.substr(11).c_str()));
+            }
+            else if(arg.compare(0, 10, "--threads=") == 0) {
+                Globals::threads = std::max(0, std::atoi(arg.substr(10).c_str()));
+            }
+            else if(arg.compare(0, 9, "--engine=") == 0) {
+                Globals::engine = Engine::parse(arg.substr(9));
+            }
+            else if(arg.compare(0, 5, "--io=") == 0) {
+                Globals::io = Reader::parse_mode(arg.substr(5));
+            }
+            else if(arg.compare(0, 11, "--dfa-file=") == 0) {
+                Globals::dfa_file = arg.substr(11);
+            }
+            else if(arg == "--stats") {
+                Globals::stats = true;
+            }
+            else if(arg == "--batch") {
+                Globals::batch = true;
+            }
+            else if(arg.compare(0, 8, "--batch=") == 0) {
+                Globals::batch  = true;
+                Globals::format = Batch::parse_format(arg.substr(8));
+            }
             else if(argn == 1) {
                 Globals::arg1 = arg;
                 ++argn;
@@ -93,6 +142,7 @@ auto Program::init(const ArgList& args) -> bool
                 throw std::runtime_error(std::string("invalid argument") + ' ' + '\'' + arg + '\'');
             }
         }
+        Globals::argn = argn;
         return true;
     };
 
@@ -101,20 +151,163 @@ auto Program::init(const ArgList& args) -> bool
 
 auto Program::main(const ArgList& args) -> void
 {
+    auto do_batch = [&](std::istream& istream, std::ostream& ostream) -> void
+    {
+        Batch    batch(istream, ostream, Globals::format, Globals::engine, Globals::flags);
+        uint64_t matches = 0;
+
+        std::ios::sync_with_stdio(false);
+        if(Globals::argn > 1) {
+            matches = batch.run(Globals::arg1);
+        }
+        else {
+            matches = batch.run();
+        }
+        if(matches == 0) {
+            Globals::exitcode = EXIT_FAILURE;
+        }
+    };
+
+    auto do_lines = [&](RegExp& regexp, std::ostream& stream) -> bool
+    {
+        const std::string& text(Globals::arg2);
+        std::vector<Line>  lines;
+
+        if(regexp.scan_lines(text.data(), text.size(), lines) == 0) {
+            return false;
+        }
+        for(auto& line : lines) {
+            stream << line.offset << ':';
+            stream.write(text.data() + line.offset, line.size);
+            stream << std::endl;
+        }
+        return true;
+    };
+
+    auto do_count = [&](RegExp& regexp, std::ostream& stream) -> bool
+    {
+        Source source;
+        Reader reader;
+        size_t count = 0;
+
+        if(Globals::argn > 2) {
+            count = regexp.count(Globals::arg2.data(), Globals::arg2.size());
+        }
+        else if((Globals::io != Reader::IO_MMAP) || (Reader::detect(STDIN_FILENO) != Reader::FORMAT_PLAIN)) {
+            /* the lines are counted chunk by chunk while the next reads (or the decompression) are pending */
+            const char* data = nullptr;
+            size_t      size = 0;
+            reader.start(STDIN_FILENO, "stdin", Globals::io);
+            if(Globals::loglevel >= LogLevel::LOG_DEBUG) {
+                stream << "🔵" << ' ' << "reading<" << Reader::name(reader.mode()) << ' ' << Reader::format_name(reader.format()) << '>' << std::endl;
+            }
+            while(reader.next(data, size) != false) {
+                count += regexp.count(data, size);
+            }
+        }
+        else {
+            source.load(STDIN_FILENO, "stdin");
+            count = regexp.count(source.data(), source.size());
+        }
+        stream << count << std::endl;
+        return count != 0;
+    };
+
+    auto do_recursive = [&](RegExp& regexp, std::ostream& stream) -> bool
+    {
+        Walker walker(regexp, stream, Globals::threads, Globals::count);
+
+        if(Globals::argn <= 2) {
+            throw std::runtime_error(std::string("no directory to walk"));
+        }
+        std::ios::sync_with_stdio(false);
+        if(Globals::loglevel >= LogLevel::LOG_DEBUG) {
+            stream << "🔵" << ' ' << "walking<" << walker.threads() << ' ' << "threads" << '>' << std::endl;
+        }
+        return walker.run(Globals::arg2) != 0;
+    };
+
+    auto do_segments = [&](RegExp& regexp) -> bool
+    {
+        const std::string& text(Globals::arg2);
+        std::vector<Input> segments;
+
+        /* the string is cut in place, as a chain of buffers would be */
+        for(size_t offset = 0; offset < text.size(); offset += Globals::segments) {
+            segments.push_back(Input { text.data() + offset, std::min(text.size() - offset, static_cast<size_t>(Globals::segments)) });
+        }
+        return regexp.execute_chain(segments.data(), segments.size());
+    };
+
+    auto do_dfa_file = [&](RegExp& regexp) -> void
+    {
+        Source               source;
+        std::vector<uint8_t> image;
+
+        /* the table is reused when it was saved for the same program, otherwise it is built and saved over a previous table only */
+        if(::access(Globals::dfa_file.c_str(), F_OK) == 0) {
+            source.open(Globals::dfa_file);
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(source.data());
+            if(regexp.load_dfa(data, source.size()) != false) {
+                return;
+            }
+            if(FullDFA::is_image(data, source.size()) == false) {
+                throw std::runtime_error(std::string("not a dfa file") + ' ' + '\'' + Globals::dfa_file + '\'');
+            }
+            source.close();
+        }
+        if(regexp.save_dfa(image) != false) {
+            std::ofstream output(Globals::dfa_file, std::ios::binary | std::ios::trunc);
+            output.write(reinterpret_cast<const char*>(image.data()), image.size());
+            if(!output) {
+                throw std::runtime_error(std::string("unable to write") + ' ' + '\'' + Globals::dfa_file + '\'');
+            }
+        }
+    };
+
     auto do_main = [&](std::ostream& stream) -> void
     {
         RegExp regexp(stream, Globals::loglevel);
 
-        if(regexp.compile(Globals::arg1) == false) {
+        regexp.set_engine(Globals::engine);
+        if(regexp.compile(Globals::arg1.data(), Globals::arg1.size(), Globals::flags) == false) {
             Globals::exitcode = EXIT_FAILURE;
             return;
         }
-        if(regexp.execute(Globals::arg2) == false) {
+        if((Globals::engine == Engine::ENGINE_FULLDFA) && (Globals::dfa_file.empty() == false)) {
+            do_dfa_file(regexp);
+        }
+        if(Globals::recursive != false) {
+            if(do_recursive(regexp, stream) == false) {
+                Globals::exitcode = EXIT_FAILURE;
+            }
+        }
+        else if(Globals::count != false) {
+            if(do_count(regexp, stream) == false) {
+                Globals::exitcode = EXIT_FAILURE;
+            }
+        }
+        else if((Globals::flags & CompileFlags::FLAG_MULTILINE) != 0) {
+            if(do_lines(regexp, stream) == false) {
+                Globals::exitcode = EXIT_FAILURE;
+            }
+        }
+        else if(Globals::segments != 0) {
+            if(do_segments(regexp) == false) {
+                Globals::exitcode = EXIT_FAILURE;
+            }
+        }
+        else if(regexp.is_match(Globals::arg2) == false) {
             Globals::exitcode = EXIT_FAILURE;
-            return;
+        }
+        if(Globals::stats != false) {
+            regexp.stats().print(stream);
         }
     };
 
+    if(Globals::batch != false) {
+        return do_batch(std::cin, std::cout);
+    }
     return do_main(std::cout);
 }
 
@@ -133,6 +326,9 @@ auto Program::help(const ArgList& args) -> void
     auto do_help = [&](std::ostream& stream) -> void
     {
         stream << "Usage: " << program_name() << " [OPTIONS...] [PATTERN] [STRING]" << std::endl;
+        stream << "       " << program_name() << " [OPTIONS...] --count [PATTERN] < FILE" << std::endl;
+        stream << "       " << program_name() << " [OPTIONS...] --recursive PATTERN DIR" << std::endl;
+        stream << "       " << program_name() << " [OPTIONS...] --batch[=FORMAT] [PATTERN]" << std::endl;
         stream << ""                                                                << std::endl;
         stream << "Options:"                                                        << std::endl;
         stream << ""                                                                << std::endl;
@@ -144,6 +340,18 @@ auto Program::help(const ArgList& args) -> void
         stream << "  -3, --print                   print log level (default)"       << std::endl;
         stream << "  -4, --debug                   debug log level"                 << std::endl;
         stream << "  -5, --trace                   trace log level"                 << std::endl;
+        stream << "  -i, --ignore-case             case-insensitive matching"       << std::endl;
+        stream << "  -u, --utf8                    UTF-8 matching (. is a character)" << std::endl;
+        stream << "  -m, --multiline               print the matching lines (^ and $ match at newlines)" << std::endl;
+        stream << "  -c, --count                   print the number of matching lines of STRING or stdin" << std::endl;
+        stream << "  -r, --recursive               print the matching lines of the files under DIR" << std::endl;
+        stream << "  --engine=NAME                 matching engine (auto, backtrack, dfa, fulldfa)" << std::endl;
+        stream << "  --dfa-file=FILE               load or save the table of the fulldfa engine" << std::endl;
+        stream << "  --io=NAME                     how --count reads stdin (mmap, uring, thread)" << std::endl;
+        stream << "  --segments=SIZE               match STRING cut into a chain of SIZE bytes buffers" << std::endl;
+        stream << "  --threads=COUNT               worker threads of --recursive (default: one per core)" << std::endl;
+        stream << "  --stats                       print the execution statistics"  << std::endl;
+        stream << "  --batch[=FORMAT]              match records read from stdin (tab, length)" << std::endl;
         stream << ""                                                                << std::endl;
     };
 
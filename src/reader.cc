@@ -0,0 +1,779 @@
+/*
+ * reader.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(ENABLE_ZLIB) && (ENABLE_ZLIB != 0)
+#include <zlib.h>
+#endif
+#if defined(ENABLE_ZSTD) && (ENABLE_ZSTD != 0)
+#include <zstd.h>
+#endif
+#include "reader.h"
+
+// ---------------------------------------------------------------------------
+// ENABLE_URING: the ring needs the kernel headers of IORING_OP_READ (5.6)
+// ---------------------------------------------------------------------------
+
+#ifndef ENABLE_URING
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+#define ENABLE_URING 1
+#else
+#define ENABLE_URING 0
+#endif
+#endif
+
+// ---------------------------------------------------------------------------
+// <anonymous>::last_byte
+// ---------------------------------------------------------------------------
+
+namespace {
+
+auto last_byte(const char* data, const size_t size, const char byte) -> const char*
+{
+#if defined(__GLIBC__)
+    return static_cast<const char*>(::memrchr(data, byte, size));
+#else
+    for(size_t index = size; index-- != 0;) {
+        if(data[index] == byte) {
+            return data + index;
+        }
+    }
+    return nullptr;
+#endif
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Reader::Ring: the io_uring queues, set up with the raw system calls
+// ---------------------------------------------------------------------------
+
+struct Reader::Ring
+{
+#if ENABLE_URING
+    int           fd;
+    void*         sq_ptr;
+    size_t        sq_size;
+    void*         cq_ptr;
+    size_t        cq_size;
+    io_uring_sqe* sqes;
+    size_t        sqes_size;
+    unsigned*     sq_head;
+    unsigned*     sq_tail;
+    unsigned*     sq_mask;
+    unsigned*     sq_array;
+    unsigned*     cq_head;
+    unsigned*     cq_tail;
+    unsigned*     cq_mask;
+    io_uring_cqe* cqes;
+#endif
+    size_t        inflight;
+};
+
+// ---------------------------------------------------------------------------
+// Reader::Decoder: the state of the decompression, owned by the reader thread
+// ---------------------------------------------------------------------------
+
+struct Reader::Decoder
+{
+    std::vector<char> input;
+    size_t            begin;   // first compressed byte not consumed yet
+    size_t            end;     // end of the compressed bytes read
+    uint64_t          offset;  // offset of the next compressed read
+    bool              drained; // the compressed input has been read up to its end
+    bool              fresh;   // no stream has been started since the last one ended
+#if defined(ENABLE_ZLIB) && (ENABLE_ZLIB != 0)
+    z_stream          zlib;
+#endif
+#if defined(ENABLE_ZSTD) && (ENABLE_ZSTD != 0)
+    ZSTD_DStream*     zstd;
+#endif
+};
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+Reader::Reader()
+    : _name()
+    , _fd(-1)
+    , _mode(IO_THREAD)
+    , _format(FORMAT_PLAIN)
+    , _seekable(false)
+    , _length(0)
+    , _memory()
+    , _slots()
+    , _requested(0)
+    , _sequence(0)
+    , _cursor(0)
+    , _carried(0)
+    , _active(false)
+    , _finished(true)
+    , _overflow()
+    , _line()
+    , _ring()
+    , _decoder()
+    , _thread()
+    , _mutex()
+    , _condition()
+    , _stopping(false)
+{
+}
+
+Reader::~Reader()
+{
+    close();
+}
+
+auto Reader::parse_mode(const std::string& name) -> uint32_t
+{
+    for(uint32_t mode = IO_MMAP; mode <= IO_THREAD; ++mode) {
+        if(name == Reader::name(mode)) {
+            return mode;
+        }
+    }
+    throw std::runtime_error(std::string("invalid io mode") + ' ' + '\'' + name + '\'');
+}
+
+auto Reader::name(const uint32_t mode) -> const char*
+{
+    switch(mode) {
+        case IO_MMAP:
+            return "mmap";
+        case IO_URING:
+            return "uring";
+        case IO_THREAD:
+            return "thread";
+        default:
+            break;
+    }
+    return "???";
+}
+
+auto Reader::format_name(const uint32_t format) -> const char*
+{
+    switch(format) {
+        case FORMAT_PLAIN:
+            return "plain";
+        case FORMAT_GZIP:
+            return "gzip";
+        case FORMAT_ZSTD:
+            return "zstd";
+        default:
+            break;
+    }
+    return "???";
+}
+
+auto Reader::supported(const uint32_t format) -> bool
+{
+    switch(format) {
+        case FORMAT_PLAIN:
+            return true;
+#if defined(ENABLE_ZLIB) && (ENABLE_ZLIB != 0)
+        case FORMAT_GZIP:
+            return true;
+#endif
+#if defined(ENABLE_ZSTD) && (ENABLE_ZSTD != 0)
+        case FORMAT_ZSTD:
+            return true;
+#endif
+        default:
+            break;
+    }
+    return false;
+}
+
+auto Reader::detect(const char* data, const size_t size) -> uint32_t
+{
+    const uint8_t* magic = reinterpret_cast<const uint8_t*>(data);
+
+    if((size >= 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b)) {
+        return FORMAT_GZIP;
+    }
+    if((size >= 4) && (magic[0] == 0x28) && (magic[1] == 0xb5) && (magic[2] == 0x2f) && (magic[3] == 0xfd)) {
+        return FORMAT_ZSTD;
+    }
+    return FORMAT_PLAIN;
+}
+
+auto Reader::detect(const int fd) -> uint32_t
+{
+    struct stat status;
+    char        magic[4];
+
+    /* only a regular file can be looked at without consuming it, a pipe is taken as is */
+    if((::fstat(fd, &status) != 0) || (S_ISREG(status.st_mode) == false)) {
+        return FORMAT_PLAIN;
+    }
+    const ssize_t count = ::pread(fd, magic, sizeof(magic), 0);
+    if(count <= 0) {
+        return FORMAT_PLAIN;
+    }
+    return detect(magic, count);
+}
+
+auto Reader::start(const int fd, const std::string& name, const uint32_t mode) -> void
+{
+    struct stat status;
+
+    close();
+    if(::fstat(fd, &status) != 0) {
+        throw std::runtime_error(std::string("unable to stat") + ' ' + '\'' + name + '\'' + ':' + ' ' + ::strerror(errno));
+    }
+    _name      = name;
+    _fd        = fd;
+    _mode      = IO_THREAD;
+    _format    = detect(fd);
+    _seekable  = S_ISREG(status.st_mode);
+    _length    = (_seekable ? status.st_size : 0);
+    _requested = 0;
+    _sequence  = 0;
+    _cursor    = 0;
+    _carried   = 0;
+    _active    = false;
+    _finished  = false;
+    _stopping  = false;
+    _overflow.clear();
+    _line.clear();
+    /* each buffer is aligned and preceded by the room where the previous one leaves its last line */
+    _memory.resize((BUFFER_COUNT * (HEADROOM + BUFFER_SIZE)) + ALIGNMENT);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(_memory.data());
+    char*           base    = _memory.data() + (((address + ALIGNMENT - 1) & ~static_cast<uintptr_t>(ALIGNMENT - 1)) - address);
+    for(size_t slot = 0; slot < BUFFER_COUNT; ++slot) {
+        _slots[slot] = Slot { base + (slot * (HEADROOM + BUFFER_SIZE)) + HEADROOM, 0, 0, 0, false };
+    }
+    /* a compressed input is decompressed by the thread, while the previous buffers are scanned */
+    if(_format != FORMAT_PLAIN) {
+        setup_decoder();
+    }
+    /* io_uring needs the offsets of a regular file, anything else goes through the thread */
+    if((mode == IO_URING) && (_seekable != false) && (_format == FORMAT_PLAIN) && (setup_ring() != false)) {
+        _mode = IO_URING;
+        for(size_t slot = 0; slot < BUFFER_COUNT; ++slot) {
+            submit(slot, _requested++);
+        }
+    }
+    else {
+        _thread = std::thread(&Reader::run_thread, this);
+    }
+}
+
+auto Reader::next(const char*& data, size_t& size) -> bool
+{
+    /*
+     * a chunk is a run of whole lines: the line cut at the end of a buffer
+     * is copied into the headroom of the next one, or set aside when it
+     * does not fit, and handed out with the rest of its bytes
+     */
+    while(_finished == false) {
+        const size_t slot = (_sequence % BUFFER_COUNT);
+        Slot&        current(_slots[slot]);
+        if(_active == false) {
+            wait(slot);
+            _active = true;
+            _cursor = 0;
+            if(current.error != 0) {
+                throw std::runtime_error(std::string("unable to read") + ' ' + '\'' + _name + '\'' + ':' + ' ' + ::strerror(current.error));
+            }
+            if(current.size == 0) {
+                _finished = true;
+                if(_overflow.empty() == false) {
+                    _line.swap(_overflow);
+                    _overflow.clear();
+                    data = _line.data();
+                    size = _line.size();
+                    return true;
+                }
+                if(_carried != 0) {
+                    data     = current.data - _carried;
+                    size     = _carried;
+                    _carried = 0;
+                    return true;
+                }
+                return false;
+            }
+        }
+        char*        base      = current.data + _cursor;
+        const size_t available = current.size - _cursor;
+        if(_overflow.empty() == false) {
+            char* newline = static_cast<char*>(::memchr(base, '\n', available));
+            if(newline != nullptr) {
+                _overflow.insert(_overflow.end(), base, newline + 1);
+                _cursor = (newline + 1) - current.data;
+                _line.swap(_overflow);
+                _overflow.clear();
+                data = _line.data();
+                size = _line.size();
+                return true;
+            }
+            _overflow.insert(_overflow.end(), base, base + available);
+            _cursor = current.size;
+        }
+        else if(available != 0) {
+            const char* newline = last_byte(base, available, '\n');
+            if(newline != nullptr) {
+                data     = base - _carried;
+                size     = (newline + 1) - data;
+                _cursor  = (newline + 1) - current.data;
+                _carried = 0;
+                return true;
+            }
+        }
+        /* the buffer has no newline left: carry its tail over and give it back */
+        Slot&        following(_slots[(_sequence + 1) % BUFFER_COUNT]);
+        const char*  tail   = current.data + _cursor - _carried;
+        const size_t length = (current.size - _cursor) + _carried;
+        _carried = 0;
+        if(_overflow.empty() == false) {
+            /* already set aside */
+        }
+        else if(length > HEADROOM) {
+            _overflow.assign(tail, tail + length);
+        }
+        else {
+            std::memcpy(following.data - length, tail, length);
+            _carried = length;
+        }
+        release(slot);
+        _sequence += 1;
+        _active    = false;
+    }
+    return false;
+}
+
+auto Reader::close() -> void
+{
+    if(_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        _thread.join();
+    }
+    if(_ring) {
+        while(_ring->inflight != 0) {
+            reap_ring(true);
+        }
+        close_ring();
+    }
+    if(_decoder) {
+        close_decoder();
+    }
+    _fd       = -1;
+    _active   = false;
+    _finished = true;
+    _overflow.clear();
+    _line.clear();
+}
+
+auto Reader::submit(const size_t slot, const uint64_t block) -> void
+{
+    Slot&          current(_slots[slot]);
+    const uint64_t offset = block * BUFFER_SIZE;
+
+    current.size  = 0;
+    current.block = block;
+    current.error = 0;
+    current.ready = false;
+    if(offset >= _length) {
+        current.ready = true;
+        return;
+    }
+#if ENABLE_URING
+    Ring&          ring(*_ring);
+    const unsigned tail  = *ring.sq_tail;
+    const unsigned index = (tail & *ring.sq_mask);
+    io_uring_sqe&  sqe(ring.sqes[index]);
+
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode    = IORING_OP_READ;
+    sqe.fd        = _fd;
+    sqe.addr      = reinterpret_cast<uintptr_t>(current.data);
+    sqe.len       = static_cast<uint32_t>(std::min(static_cast<uint64_t>(BUFFER_SIZE), _length - offset));
+    sqe.off       = offset;
+    sqe.user_data = slot;
+    ring.sq_array[index] = index;
+    __atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+    while(::syscall(__NR_io_uring_enter, ring.fd, 1, 0, 0, nullptr, 0) < 0) {
+        if(errno != EINTR) {
+            throw std::runtime_error(std::string("unable to queue a read of") + ' ' + '\'' + _name + '\'' + ':' + ' ' + ::strerror(errno));
+        }
+    }
+    ring.inflight += 1;
+#endif
+}
+
+auto Reader::wait(const size_t slot) -> void
+{
+    if(_mode == IO_URING) {
+        while(_slots[slot].ready == false) {
+            reap_ring(true);
+        }
+    }
+    else {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [&]() -> bool { return _slots[slot].ready; });
+    }
+}
+
+auto Reader::release(const size_t slot) -> void
+{
+    if(_mode == IO_URING) {
+        submit(slot, _requested++);
+    }
+    else {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _slots[slot].ready = false;
+        }
+        _condition.notify_all();
+    }
+}
+
+auto Reader::read_block(const uint64_t block, char* data) -> ssize_t
+{
+    size_t used = 0;
+
+    if(_decoder) {
+        return decode_block(data);
+    }
+    /* a regular file is read at the offset of the block, a pipe in sequence */
+    while(used < BUFFER_SIZE) {
+        const ssize_t count = (_seekable != false
+                            ? ::pread(_fd, data + used, BUFFER_SIZE - used, (block * BUFFER_SIZE) + used)
+                            : ::read(_fd, data + used, BUFFER_SIZE - used));
+        if(count < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        if(count == 0) {
+            break;
+        }
+        used += count;
+    }
+    return static_cast<ssize_t>(used);
+}
+
+auto Reader::setup_ring() -> bool
+{
+#if ENABLE_URING
+    io_uring_params params;
+    std::unique_ptr<Ring> ring(new Ring());
+
+    std::memset(&params, 0, sizeof(params));
+    ring->fd = static_cast<int>(::syscall(__NR_io_uring_setup, BUFFER_COUNT, &params));
+    if(ring->fd < 0) {
+        return false;
+    }
+    ring->sq_size   = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    ring->cq_size   = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    if((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        ring->sq_size = ring->cq_size = std::max(ring->sq_size, ring->cq_size);
+    }
+    ring->sq_ptr = ::mmap(nullptr, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ptr = ring->sq_ptr;
+    if((ring->sq_ptr != MAP_FAILED) && ((params.features & IORING_FEAT_SINGLE_MMAP) == 0)) {
+        ring->cq_ptr = ::mmap(nullptr, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    }
+    void* sqes = ::mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    ring->sqes = (sqes != MAP_FAILED ? static_cast<io_uring_sqe*>(sqes) : nullptr);
+    if((ring->sq_ptr == MAP_FAILED) || (ring->cq_ptr == MAP_FAILED) || (ring->sqes == nullptr)) {
+        if(ring->sqes != nullptr) {
+            static_cast<void>(::munmap(ring->sqes, ring->sqes_size));
+        }
+        if((ring->cq_ptr != MAP_FAILED) && (ring->cq_ptr != ring->sq_ptr)) {
+            static_cast<void>(::munmap(ring->cq_ptr, ring->cq_size));
+        }
+        if(ring->sq_ptr != MAP_FAILED) {
+            static_cast<void>(::munmap(ring->sq_ptr, ring->sq_size));
+        }
+        static_cast<void>(::close(ring->fd));
+        return false;
+    }
+    char* sq = static_cast<char*>(ring->sq_ptr);
+    char* cq = static_cast<char*>(ring->cq_ptr);
+    ring->sq_head  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->sq_tail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cq_head  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask  = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    ring->inflight = 0;
+    _ring = std::move(ring);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto Reader::reap_ring(const bool block) -> void
+{
+#if ENABLE_URING
+    Ring&    ring(*_ring);
+    unsigned head = *ring.cq_head;
+
+    if((block != false) && (head == __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE))) {
+        while(::syscall(__NR_io_uring_enter, ring.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            if(errno != EINTR) {
+                throw std::runtime_error(std::string("unable to wait for a read of") + ' ' + '\'' + _name + '\'' + ':' + ' ' + ::strerror(errno));
+            }
+        }
+    }
+    while(head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe& cqe(ring.cqes[head & *ring.cq_mask]);
+        Slot&               current(_slots[cqe.user_data]);
+        const uint64_t      offset   = current.block * BUFFER_SIZE;
+        const size_t        expected = static_cast<size_t>(std::min(static_cast<uint64_t>(BUFFER_SIZE), _length - offset));
+        if(cqe.res < 0) {
+            current.error = -cqe.res;
+        }
+        else if(static_cast<size_t>(cqe.res) < expected) {
+            /* a short read is finished in place */
+            const ssize_t count = read_block(current.block, current.data);
+            current.size  = (count > 0 ? count : 0);
+            current.error = (count < 0 ? static_cast<int>(-count) : 0);
+        }
+        else {
+            current.size = cqe.res;
+        }
+        current.ready = true;
+        ring.inflight -= 1;
+        __atomic_store_n(ring.cq_head, ++head, __ATOMIC_RELEASE);
+    }
+#else
+    static_cast<void>(block);
+#endif
+}
+
+auto Reader::close_ring() -> void
+{
+#if ENABLE_URING
+    Ring& ring(*_ring);
+
+    static_cast<void>(::munmap(ring.sqes, ring.sqes_size));
+    if(ring.cq_ptr != ring.sq_ptr) {
+        static_cast<void>(::munmap(ring.cq_ptr, ring.cq_size));
+    }
+    static_cast<void>(::munmap(ring.sq_ptr, ring.sq_size));
+    static_cast<void>(::close(ring.fd));
+#endif
+    _ring.reset();
+}
+
+auto Reader::setup_decoder() -> void
+{
+    std::unique_ptr<Decoder> decoder(new Decoder());
+
+    if(supported(_format) == false) {
+        throw std::runtime_error(std::string("unable to decompress") + ' ' + '\'' + _name + '\'' + ':' + ' ' + format_name(_format) + ' ' + "support is not compiled in");
+    }
+    decoder->input.resize(INPUT_SIZE);
+    decoder->begin   = 0;
+    decoder->end     = 0;
+    decoder->offset  = 0;
+    decoder->drained = false;
+    decoder->fresh   = true;
+#if defined(ENABLE_ZLIB) && (ENABLE_ZLIB != 0)
+    if(_format == FORMAT_GZIP) {
+        std::memset(&decoder->zlib, 0, sizeof(decoder->zlib));
+        /* a window of 32K with a gzip header */
+        if(::inflateInit2(&decoder->zlib, 15 + 16) != Z_OK) {
+            throw std::runtime_error(std::string("unable to decompress") + ' ' + '\'' + _name + '\'');
+        }
+    }
+#endif
+#if defined(ENABLE_ZSTD) && (ENABLE_ZSTD != 0)
+    decoder->zstd = nullptr;
+    if(_format == FORMAT_ZSTD) {
+        decoder->zstd = ::ZSTD_createDStream();
+        if(decoder->zstd == nullptr) {
+            throw std::runtime_error(std::string("unable to decompress") + ' ' + '\'' + _name + '\'');
+        }
+    }
+#endif
+    _decoder = std::move(decoder);
+}
+
+auto Reader::decode_block(char* data) -> ssize_t
+{
+    Decoder& decoder(*_decoder);
+    size_t   used = 0;
+
+    /*
+     * the output of the decompression fills the buffer, the compressed
+     * input is read on demand: a gzip file may hold several members and
+     * a zstd file several frames, one after the other
+     */
+    while(used < BUFFER_SIZE) {
+        if((decoder.begin == decoder.end) && (decoder.drained == false)) {
+            const ssize_t count = read_input(decoder.input.data(), decoder.input.size(), decoder.offset);
+            if(count < 0) {
+                return count;
+            }
+            decoder.begin    = 0;
+            decoder.end      = count;
+            decoder.offset  += count;
+            decoder.drained  = (count == 0);
+        }
+        const size_t begin    = decoder.begin;
+        const size_t produced = used;
+#if defined(ENABLE_ZLIB) && (ENABLE_ZLIB != 0)
+        if(_format == FORMAT_GZIP) {
+            z_stream& stream(decoder.zlib);
+            stream.next_in   = reinterpret_cast<Bytef*>(decoder.input.data() + decoder.begin);
+            stream.avail_in  = static_cast<uInt>(decoder.end - decoder.begin);
+            stream.next_out  = reinterpret_cast<Bytef*>(data + used);
+            stream.avail_out = static_cast<uInt>(BUFFER_SIZE - used);
+            const int status = ::inflate(&stream, Z_NO_FLUSH);
+            decoder.begin = decoder.end - stream.avail_in;
+            used          = BUFFER_SIZE - stream.avail_out;
+            if((status != Z_OK) && (status != Z_STREAM_END) && (status != Z_BUF_ERROR)) {
+                return -EBADMSG;
+            }
+            if(status == Z_STREAM_END) {
+                static_cast<void>(::inflateReset(&stream));
+                decoder.fresh = true;
+                continue;
+            }
+            if((decoder.begin != begin) || (used != produced)) {
+                decoder.fresh = false;
+            }
+        }
+#endif
+#if defined(ENABLE_ZSTD) && (ENABLE_ZSTD != 0)
+        if(_format == FORMAT_ZSTD) {
+            ZSTD_inBuffer  input  { decoder.input.data() + decoder.begin, decoder.end - decoder.begin, 0 };
+            ZSTD_outBuffer output { data + used, BUFFER_SIZE - used, 0 };
+            const size_t   status = ::ZSTD_decompressStream(decoder.zstd, &output, &input);
+            if(::ZSTD_isError(status) != 0) {
+                return -EBADMSG;
+            }
+            decoder.begin += input.pos;
+            used          += output.pos;
+            if((decoder.begin != begin) || (used != produced)) {
+                decoder.fresh = (status == 0);
+            }
+        }
+#endif
+        if((decoder.begin == begin) && (used == produced)) {
+            /* no progress: the input is over, truncated in the middle of a stream, or not valid */
+            if((decoder.begin != decoder.end) || (decoder.fresh == false)) {
+                return -EBADMSG;
+            }
+            if(decoder.drained != false) {
+                break;
+            }
+        }
+    }
+    return static_cast<ssize_t>(used);
+}
+
+auto Reader::read_input(char* data, const size_t size, const uint64_t offset) -> ssize_t
+{
+    for(;;) {
+        const ssize_t count = (_seekable != false
+                            ? ::pread(_fd, data, size, offset)
+                            : ::read(_fd, data, size));
+        if(count < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        return count;
+    }
+}
+
+auto Reader::close_decoder() -> void
+{
+#if defined(ENABLE_ZLIB) && (ENABLE_ZLIB != 0)
+    if(_format == FORMAT_GZIP) {
+        static_cast<void>(::inflateEnd(&_decoder->zlib));
+    }
+#endif
+#if defined(ENABLE_ZSTD) && (ENABLE_ZSTD != 0)
+    if(_decoder->zstd != nullptr) {
+        static_cast<void>(::ZSTD_freeDStream(_decoder->zstd));
+    }
+#endif
+    _decoder.reset();
+}
+
+auto Reader::run_thread() -> void
+{
+    for(uint64_t block = 0;; ++block) {
+        const size_t slot = (block % BUFFER_COUNT);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [&]() -> bool { return _stopping || (_slots[slot].ready == false); });
+            if(_stopping != false) {
+                return;
+            }
+        }
+        const ssize_t count = read_block(block, _slots[slot].data);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _slots[slot].size  = (count > 0 ? count : 0);
+            _slots[slot].error = (count < 0 ? static_cast<int>(-count) : 0);
+            _slots[slot].block = block;
+            _slots[slot].ready = true;
+        }
+        _condition.notify_all();
+        if(count <= 0) {
+            return;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
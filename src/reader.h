@@ -0,0 +1,152 @@
+/*
+ * reader.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Reader_h__
+#define __Reader_h__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// ---------------------------------------------------------------------------
+// Reader: a file read ahead into a ring of buffers and handed out in lines
+// ---------------------------------------------------------------------------
+
+class Reader
+{
+public: // public interface
+    Reader();
+
+    Reader(Reader&&) = delete;
+
+    Reader(const Reader&) = delete;
+
+    Reader& operator=(Reader&&) = delete;
+
+    Reader& operator=(const Reader&) = delete;
+
+    virtual ~Reader();
+
+    static constexpr uint32_t IO_MMAP   = 0; // the whole file through a Source
+    static constexpr uint32_t IO_URING  = 1; // reads queued to io_uring
+    static constexpr uint32_t IO_THREAD = 2; // reads done by a reader thread
+
+    static constexpr uint32_t FORMAT_PLAIN = 0; // read as is
+    static constexpr uint32_t FORMAT_GZIP  = 1; // inflated with zlib
+    static constexpr uint32_t FORMAT_ZSTD  = 2; // decompressed with zstd
+
+    static constexpr size_t BUFFER_SIZE  = 1 << 20; // bytes per read
+    static constexpr size_t BUFFER_COUNT = 4;       // reads in flight
+    static constexpr size_t HEADROOM     = 1 << 16; // room for a line carried over, in front of each buffer
+    static constexpr size_t ALIGNMENT    = 4096;
+    static constexpr size_t INPUT_SIZE   = 1 << 18; // compressed bytes per read
+
+    static auto parse_mode(const std::string& name) -> uint32_t;
+
+    static auto name(const uint32_t mode) -> const char*;
+
+    static auto format_name(const uint32_t format) -> const char*;
+
+    static auto supported(const uint32_t format) -> bool;
+
+    static auto detect(const char* data, const size_t size) -> uint32_t;
+
+    static auto detect(const int fd) -> uint32_t;
+
+    auto start(const int fd, const std::string& name, const uint32_t mode) -> void;
+
+    auto next(const char*& data, size_t& size) -> bool;
+
+    auto close() -> void;
+
+    auto mode() const -> uint32_t
+    {
+        return _mode;
+    }
+
+    auto format() const -> uint32_t
+    {
+        return _format;
+    }
+
+protected: // protected interface
+    struct Slot
+    {
+        char*    data;
+        size_t   size;
+        uint64_t block;
+        int      error;
+        bool     ready;
+    };
+
+    struct Ring;
+
+    struct Decoder;
+
+    auto submit(const size_t slot, const uint64_t block) -> void;
+
+    auto wait(const size_t slot) -> void;
+
+    auto release(const size_t slot) -> void;
+
+    auto read_block(const uint64_t block, char* data) -> ssize_t;
+
+    auto setup_ring() -> bool;
+
+    auto reap_ring(const bool block) -> void;
+
+    auto close_ring() -> void;
+
+    auto setup_decoder() -> void;
+
+    auto decode_block(char* data) -> ssize_t;
+
+    auto read_input(char* data, const size_t size, const uint64_t offset) -> ssize_t;
+
+    auto close_decoder() -> void;
+
+    auto run_thread() -> void;
+
+protected: // protected data
+    std::string              _name;
+    int                      _fd;
+    uint32_t                 _mode;
+    uint32_t                 _format;
+    bool                     _seekable;
+    uint64_t                 _length;
+    std::vector<char>        _memory;
+    Slot                     _slots[BUFFER_COUNT];
+    uint64_t                 _requested;
+    uint64_t                 _sequence;
+    size_t                   _cursor;
+    size_t                   _carried;
+    bool                     _active;
+    bool                     _finished;
+    std::vector<char>        _overflow;
+    std::vector<char>        _line;
+    std::unique_ptr<Ring>    _ring;
+    std::unique_ptr<Decoder> _decoder;
+    std::thread              _thread;
+    std::mutex               _mutex;
+    std::condition_variable  _condition;
+    bool                     _stopping;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Reader_h__ */
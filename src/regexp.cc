@@ -29,8 +29,11 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <map>
 #include <iostream>
+#include <algorithm>
 #include <stdexcept>
+#include "scan.h"
 #include "regexp.h"
 
 // ---------------------------------------------------------------------------
@@ -41,21 +44,621 @@ RegExp::RegExp(OStream& ostream, const uint32_t loglevel)
     : _ostream(ostream)
     , _loglevel(loglevel)
     , _bytecode()
+    , _compiler(_bytecode, _ostream, _loglevel)
+    , _error { CompileError::ERR_NONE, 0 }
+    , _stats()
+    , _automaton()
+    , _dfa(_automaton, _stats, _ostream, _loglevel)
+    , _full(_stats, _ostream, _loglevel)
+    , _scratch()
+    , _engine(Engine::ENGINE_AUTO)
+    , _flags(CompileFlags::FLAG_NONE)
+    , _literal()
+    , _first()
+    , _prefiltered(false)
+    , _prepared(false)
+    , _built(false)
 {
+    _literal.clear();
 }
 
 auto RegExp::compile(const std::string& string) -> bool
 {
-    Compiler compiler(_bytecode, _ostream, _loglevel);
+    return compile(string.data(), string.size());
+}
+
+auto RegExp::compile(const char* data, const size_t size) -> bool
+{
+    return compile(data, size, CompileFlags::FLAG_NONE);
+}
+
+auto RegExp::compile(const char* data, const size_t size, const uint32_t flags) -> bool
+{
+    _prepared = false;
+    _built    = false;
+    _flags    = flags;
+    _automaton.clear();
+    _dfa.reset();
+    _full.clear();
+    if(_loglevel >= LogLevel::LOG_DEBUG) {
+        Compiler<TraceOn> compiler(_bytecode, _ostream, _loglevel);
+        const bool        status = compiler.compile(data, size, flags);
+
+        _error       = compiler.error();
+        _literal     = compiler.literal();
+        _prefiltered = Executor<TraceOff>(_bytecode, _stats, _ostream, _loglevel).prefiltered(_first.bits);
+        return status;
+    }
+    else {
+        const bool status = _compiler.compile(data, size, flags);
 
-    return compiler.compile(string);
+        _error       = _compiler.error();
+        _literal     = _compiler.literal();
+        _prefiltered = Executor<TraceOff>(_bytecode, _stats, _ostream, _loglevel).prefiltered(_first.bits);
+        return status;
+    }
+}
+
+auto RegExp::compile(const RegExp& regexp) -> bool
+{
+    /* the program is taken as compiled, the engines build their own state on the first match */
+    _prepared    = false;
+    _built       = false;
+    _flags       = regexp._flags;
+    _engine      = regexp._engine;
+    _error       = regexp._error;
+    _literal     = regexp._literal;
+    _first       = regexp._first;
+    _prefiltered = regexp._prefiltered;
+    _automaton.clear();
+    _dfa.reset();
+    _full.clear();
+    _bytecode.assign(regexp._bytecode);
+
+    return _error.code == CompileError::ERR_NONE;
 }
 
 auto RegExp::execute(const std::string& string) -> bool
 {
-    Executor executor(_bytecode, _ostream, _loglevel);
+    return execute(string.data(), string.size());
+}
+
+auto RegExp::execute(const char* data, const size_t size) -> bool
+{
+    return execute(data, size, _scratch);
+}
+
+auto RegExp::execute(const char* data, const size_t size, MatchScratch& scratch) -> bool
+{
+    const uint32_t engine = select(data, size, true);
+    bool           status = false;
+
+    _stats.reset();
+    if(engine == Engine::ENGINE_LITERAL) {
+        status = match_literal(data, size);
+    }
+    else if(engine == Engine::ENGINE_DFA) {
+        status = _dfa.execute(data, size, scratch);
+    }
+    else if(engine == Engine::ENGINE_FULLDFA) {
+        status = _full.execute(data, size);
+    }
+    else if(_loglevel >= LogLevel::LOG_TRACE) {
+        Executor<TraceOn> executor(_bytecode, _stats, _ostream, _loglevel);
+
+        status = executor.execute(data, size);
+    }
+    else {
+        Executor<TraceOff> executor(_bytecode, _stats, _ostream, _loglevel);
+
+        status = executor.execute(data, size);
+    }
+    count_reserved(scratch);
+    _stats.count_engine(engine);
+
+    return status;
+}
+
+auto RegExp::is_match(const std::string& string) -> bool
+{
+    return is_match(string.data(), string.size());
+}
+
+auto RegExp::is_match(const char* data, const size_t size) -> bool
+{
+    return is_match(data, size, _scratch);
+}
+
+auto RegExp::is_match(const char* data, const size_t size, MatchScratch& scratch) -> bool
+{
+    const uint32_t engine = select(data, size, true);
+    bool           status = false;
+
+    _stats.reset();
+    /* the lazy DFA already stops on the first accepting state */
+    if(engine == Engine::ENGINE_LITERAL) {
+        status = match_literal(data, size);
+    }
+    else if(engine == Engine::ENGINE_DFA) {
+        status = _dfa.execute(data, size, scratch);
+    }
+    else if(engine == Engine::ENGINE_FULLDFA) {
+        status = _full.execute(data, size);
+    }
+    else if(_loglevel >= LogLevel::LOG_TRACE) {
+        Executor<TraceOn> executor(_bytecode, _stats, _ostream, _loglevel);
+
+        status = executor.is_match(data, size);
+    }
+    else {
+        Executor<TraceOff> executor(_bytecode, _stats, _ostream, _loglevel);
+
+        status = executor.is_match(data, size);
+    }
+    count_reserved(scratch);
+    _stats.count_engine(engine);
+
+    return status;
+}
+
+auto RegExp::scan_lines(const char* data, const size_t size, std::vector<Line>& lines) -> size_t
+{
+    return scan_lines(data, size, lines, _scratch);
+}
+
+auto RegExp::scan_lines(const char* data, const size_t size, std::vector<Line>& lines, MatchScratch& scratch) -> size_t
+{
+    lines.clear();
+    return scan(data, size, &lines, scratch);
+}
+
+auto RegExp::count(const char* data, const size_t size) -> size_t
+{
+    return count(data, size, _scratch);
+}
+
+auto RegExp::count(const char* data, const size_t size, MatchScratch& scratch) -> size_t
+{
+    return scan(data, size, nullptr, scratch);
+}
+
+auto RegExp::execute_batch(const Input* inputs, const size_t count, uint64_t* results) -> size_t
+{
+    return execute_batch(inputs, count, results, _scratch);
+}
+
+auto RegExp::execute_batch(const Input* inputs, const size_t count, uint64_t* results, MatchScratch& scratch) -> size_t
+{
+    uint32_t engine  = _engine;
+    size_t   matched = 0;
 
-    return executor.execute(string);
+    /* the lanes of the DFA hide the latency of each input, so the batch runs it unless another engine was asked for */
+    if(_literal.pure != false) {
+        engine = Engine::ENGINE_LITERAL;
+    }
+    else if((engine == Engine::ENGINE_FULLDFA) && (prepare_full() == false)) {
+        engine = Engine::ENGINE_DFA;
+    }
+    if((engine == Engine::ENGINE_AUTO) || (engine == Engine::ENGINE_DFA)) {
+        engine = (prepare_automaton() != false ? Engine::ENGINE_DFA : Engine::ENGINE_BACKTRACK);
+    }
+    _stats.reset();
+    if(engine == Engine::ENGINE_DFA) {
+        matched = _dfa.execute_batch(inputs, count, results, scratch);
+    }
+    else {
+        Executor<TraceOff> executor(_bytecode, _stats, _ostream, LogLevel::LOG_QUIET);
+        size_t             position = 0;
+
+        for(size_t word = 0; word < ((count + 63) >> 6); ++word) {
+            results[word] = 0;
+        }
+        for(size_t index = 0; index < count; ++index) {
+            const Input& input(inputs[index]);
+            bool         status = false;
+            if(engine == Engine::ENGINE_LITERAL) {
+                status = _literal.search(input.data, input.size, position);
+            }
+            else if(engine == Engine::ENGINE_FULLDFA) {
+                status = _full.execute(input.data, input.size);
+            }
+            else {
+                status = executor.is_match(input.data, input.size);
+            }
+            if(status != false) {
+                results[index >> 6] |= (static_cast<uint64_t>(1) << (index & 63));
+                ++matched;
+            }
+        }
+    }
+    count_reserved(scratch);
+    _stats.count_engine(engine);
+
+    return matched;
+}
+
+auto RegExp::execute_chain(const Input* segments, const size_t count) -> bool
+{
+    return execute_chain(segments, count, _scratch);
+}
+
+auto RegExp::execute_chain(const Input* segments, const size_t count, MatchScratch& scratch) -> bool
+{
+    size_t size = 0;
+
+    for(size_t index = 0; index < count; ++index) {
+        size += segments[index].size;
+    }
+    uint32_t engine = select(nullptr, size, false);
+    bool     status = false;
+
+    /* the backtracker goes back and forth over a contiguous input, a chain is read in place by the DFA or the literal search only */
+    if(engine == Engine::ENGINE_BACKTRACK) {
+        if(prepare_automaton() == false) {
+            throw std::runtime_error(std::string("the backtracking executor cannot match a chain of segments"));
+        }
+        if(_loglevel >= LogLevel::LOG_ALERT) {
+            _ostream << "🟠" << ' ' << "the backtracking executor cannot match a chain of segments, the dfa engine is used instead" << std::endl;
+        }
+        engine = Engine::ENGINE_DFA;
+    }
+    _stats.reset();
+    if(engine == Engine::ENGINE_LITERAL) {
+        status = match_literal_chain(segments, count, size, scratch);
+    }
+    else if(engine == Engine::ENGINE_DFA) {
+        status = _dfa.execute_chain(segments, count, scratch);
+    }
+    else {
+        status = _full.execute_chain(segments, count);
+    }
+    count_reserved(scratch);
+    _stats.count_engine(engine);
+
+    return status;
+}
+
+auto RegExp::save_dfa(std::vector<uint8_t>& image) -> bool
+{
+    image.clear();
+    if((_literal.pure == false) && prepare_full()) {
+        _full.save(image);
+        return true;
+    }
+    return false;
+}
+
+auto RegExp::load_dfa(const uint8_t* data, const size_t size) -> bool
+{
+    if((_literal.pure == false) && prepare_automaton() && _full.load(_bytecode, data, size)) {
+        _built = true;
+        return true;
+    }
+    return false;
+}
+
+auto RegExp::scan(const char* data, const size_t size, std::vector<Line>* lines, MatchScratch& scratch) -> size_t
+{
+    Executor<TraceOff> executor(_bytecode, _stats, _ostream, LogLevel::LOG_QUIET);
+    const uint32_t     engine    = select(data, size, true);
+    const bool         literal   = (engine == Engine::ENGINE_LITERAL);
+    const bool         dfa       = (engine == Engine::ENGINE_DFA);
+    const bool         full      = (engine == Engine::ENGINE_FULLDFA);
+    const bool         multiline = ((_flags & CompileFlags::FLAG_MULTILINE) != 0);
+    size_t             offset    = 0;
+    size_t             matched   = 0;
+
+    /*
+     * the span holds the first match over the rest of the buffer: the DFA
+     * only knows where it ends, so its span starts where the search started
+     */
+    auto find = [&](const size_t from, size_t& first, size_t& last) -> bool
+    {
+        if(literal != false) {
+            if(_literal.search(data + from, size - from, first) == false) {
+                _stats.count_bytes(size - from);
+                return false;
+            }
+            first += from;
+            last   = first + _literal.bytes.size();
+            _stats.count_bytes(last - from);
+            return true;
+        }
+        if(dfa != false) {
+            if(_dfa.scan(data + from, size - from, scratch) == false) {
+                return false;
+            }
+            first = from;
+            last  = from + _dfa.position();
+            return true;
+        }
+        if(full != false) {
+            if(_full.scan(data + from, size - from) == false) {
+                return false;
+            }
+            first = from;
+            last  = from + _full.position();
+            return true;
+        }
+        if(executor.is_match(data + from, size - from) == false) {
+            return false;
+        }
+        first = from + executor.position();
+        last  = first + executor.length();
+        return true;
+    };
+
+    auto verify = [&](const size_t line_begin, const size_t line_end) -> bool
+    {
+        size_t position = 0;
+        if(literal != false) {
+            _stats.count_bytes(line_end - line_begin);
+            return _literal.search(data + line_begin, line_end - line_begin, position);
+        }
+        if(dfa != false) {
+            return _dfa.scan(data + line_begin, line_end - line_begin, scratch);
+        }
+        if(full != false) {
+            return _full.scan(data + line_begin, line_end - line_begin);
+        }
+        return executor.is_match(data + line_begin, line_end - line_begin);
+    };
+
+    /*
+     * the buffer is scanned in one pass: the line boundaries are only looked
+     * up around the candidate, the last byte of the DFA span or the first one
+     * of the backtracker span, and the scan resumes after its line. A match
+     * spanning several lines is never reported: its line is matched again on
+     * its own unless the span lies within it in multiline mode. The minimal
+     * DFA may stop before the end of the match it has found, so its line is
+     * always matched again
+     */
+    _stats.reset();
+    while(offset < size) {
+        size_t first = 0;
+        size_t last  = 0;
+        if(find(offset, first, last) == false) {
+            break;
+        }
+        const size_t candidate = (((dfa != false) || (full != false)) ? std::max(last, offset + 1) - 1 : first);
+        size_t       line_end  = candidate;
+        if((candidate == size) || (data[candidate] != '\n')) {
+            line_end += Scan::line_end(data + candidate, size - candidate);
+        }
+        const size_t line_begin = offset + Scan::line_begin(data + offset, line_end - offset);
+        if(line_begin == size) {
+            break;
+        }
+        const bool local = ((multiline != false) && (full == false) && (line_begin <= first) && (last <= line_end));
+        if((local != false) || (verify(line_begin, line_end) != false)) {
+            if(lines != nullptr) {
+                lines->push_back(Line { line_begin, line_end - line_begin });
+            }
+            ++matched;
+        }
+        offset = line_end + 1;
+    }
+    count_reserved(scratch);
+    _stats.count_engine(engine);
+
+    return matched;
+}
+
+auto RegExp::select(const char* data, const size_t size, const bool contiguous) -> uint32_t
+{
+    uint32_t engine = _engine;
+
+    /*
+     * the backtracker wins when it can skip to its first character, or to
+     * the next line, and that character is rare enough, or when it only has
+     * one offset to try, and as long as no repetition can make it go over
+     * the input again and again. Otherwise the DFA reads each byte once
+     */
+    if(_literal.pure != false) {
+        engine = Engine::ENGINE_LITERAL;
+    }
+    else if(engine == Engine::ENGINE_AUTO) {
+        const uint32_t repetitions = _bytecode.repetitions();
+        const bool     anchored    = _bytecode.anchored_begin();
+        if(contiguous == false) {
+            /* a chain of segments is read in place by the DFA only */
+            engine = Engine::ENGINE_DFA;
+        }
+        else if(repetitions >= 2) {
+            engine = Engine::ENGINE_DFA;
+        }
+        else if((repetitions != 0) && (size > MAX_BACKTRACK_INPUT)) {
+            engine = Engine::ENGINE_DFA;
+        }
+        else if((anchored == false) && (size >= MIN_DFA_INPUT) && (selective(data, size) == false)) {
+            engine = Engine::ENGINE_DFA;
+        }
+        else {
+            engine = Engine::ENGINE_BACKTRACK;
+        }
+        if((engine == Engine::ENGINE_DFA) && prepare_automaton() && (_automaton.size() > MAX_DFA_NODES)) {
+            engine = Engine::ENGINE_BACKTRACK;
+        }
+    }
+    if((engine == Engine::ENGINE_FULLDFA) && (prepare_full() == false)) {
+        engine = Engine::ENGINE_DFA;
+    }
+    if((engine == Engine::ENGINE_DFA) && (prepare_automaton() == false)) {
+        engine = Engine::ENGINE_BACKTRACK;
+    }
+    if(_loglevel >= LogLevel::LOG_DEBUG) {
+        _ostream << "🔵" << ' ' << "selecting" << '<' << Engine::name(engine) << '>' << std::endl;
+    }
+    return engine;
+}
+
+auto RegExp::selective(const char* data, const size_t size) -> bool
+{
+    const size_t sample = std::min(size, static_cast<size_t>(PREFILTER_SAMPLE));
+    size_t       hits   = 0;
+
+    /* the backtracker tries a match on every byte of the set, so the start of the input tells how often it would stop */
+    if(_prefiltered == false) {
+        return false;
+    }
+    for(size_t index = 0; index < sample; ++index) {
+        if(_first.has(static_cast<uint8_t>(data[index])) != false) {
+            ++hits;
+        }
+    }
+    return (hits * PREFILTER_DENSITY) <= sample;
+}
+
+auto RegExp::match_literal(const char* data, const size_t size) -> bool
+{
+    size_t     position = 0;
+    const bool status   = _literal.search(data, size, position);
+
+    if(_loglevel >= LogLevel::LOG_PRINT) {
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        _ostream.write(data, size);
+        _ostream << '>' << std::endl;
+    }
+    _stats.count_bytes(status != false ? position + _literal.bytes.size() : size);
+    if(status != false) {
+        if(_loglevel >= LogLevel::LOG_ALERT) {
+            _ostream << "🟢" << ' ' << "the string matches the regular expression" << std::endl;
+        }
+        return true;
+    }
+    if(_loglevel >= LogLevel::LOG_ERROR) {
+        _ostream << "🔴" << ' ' << "the string does not match the regular expression" << std::endl;
+    }
+    return false;
+}
+
+auto RegExp::match_literal_chain(const Input* segments, const size_t count, const size_t size, MatchScratch& scratch) -> bool
+{
+    const std::string& bytes(_literal.bytes);
+    const size_t       length = bytes.size();
+    std::vector<char>& window(scratch.window);
+    bool               status = false;
+
+    /* compares the literal with the chain from a logical offset, across as many segments as needed */
+    auto compare = [&](size_t offset) -> bool
+    {
+        size_t matched = 0;
+        for(size_t index = 0; (index < count) && (matched < length); ++index) {
+            const Input& segment(segments[index]);
+            if(offset >= segment.size) {
+                offset -= segment.size;
+                continue;
+            }
+            const size_t chunk = std::min(segment.size - offset, length - matched);
+            if(::memcmp(segment.data + offset, bytes.data() + matched, chunk) != 0) {
+                return false;
+            }
+            matched += chunk;
+            offset   = 0;
+        }
+        return matched == length;
+    };
+
+    /*
+     * an unanchored literal is searched within each segment with the
+     * literal scan, then across each boundary within a window made of
+     * the bytes around it, one less than the literal on each side, the
+     * bytes before the boundary being copied back to front
+     */
+    auto search = [&]() -> bool
+    {
+        const size_t span = length - 1;
+        for(size_t index = 0; index < count; ++index) {
+            const Input& segment(segments[index]);
+            if(Scan::find_literal(segment.data, segment.size, bytes.data(), length) + length <= segment.size) {
+                return true;
+            }
+        }
+        if(window.size() < (span * 2)) {
+            window.resize(span * 2);
+        }
+        for(size_t index = 0; (index + 1) < count; ++index) {
+            char* first = window.data() + span;
+            char* last  = window.data() + span;
+            for(size_t other = index + 1; (other-- > 0) && (first > window.data());) {
+                const Input& segment(segments[other]);
+                const size_t chunk = std::min(segment.size, static_cast<size_t>(first - window.data()));
+                first -= chunk;
+                ::memcpy(first, segment.data + segment.size - chunk, chunk);
+            }
+            for(size_t other = index + 1; (other < count) && (last < (window.data() + (span * 2))); ++other) {
+                const Input& segment(segments[other]);
+                const size_t chunk = std::min(segment.size, static_cast<size_t>(window.data() + (span * 2) - last));
+                ::memcpy(last, segment.data, chunk);
+                last += chunk;
+            }
+            const size_t extent = static_cast<size_t>(last - first);
+            if((Scan::find_literal(first, extent, bytes.data(), length) + length) <= extent) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if(_loglevel >= LogLevel::LOG_PRINT) {
+        _ostream << "🔵" << ' ' << "comparing" << '<';
+        for(size_t index = 0; index < count; ++index) {
+            _ostream.write(segments[index].data, segments[index].size);
+        }
+        _ostream << '>' << std::endl;
+    }
+    _stats.count_bytes(size);
+    if(length > size) {
+        status = false;
+    }
+    else if(_literal.begin != false) {
+        status = ((_literal.end == false) || (length == size)) && compare(0);
+    }
+    else if(_literal.end != false) {
+        status = compare(size - length);
+    }
+    else {
+        status = (length == 0) || search();
+    }
+    if(status != false) {
+        if(_loglevel >= LogLevel::LOG_ALERT) {
+            _ostream << "🟢" << ' ' << "the string matches the regular expression" << std::endl;
+        }
+        return true;
+    }
+    if(_loglevel >= LogLevel::LOG_ERROR) {
+        _ostream << "🔴" << ' ' << "the string does not match the regular expression" << std::endl;
+    }
+    return false;
+}
+
+auto RegExp::prepare_automaton() -> bool
+{
+    if(_prepared == false) {
+        _prepared = true;
+        /* the auto mode shows its choice under --debug, an engine that was asked for is never replaced silently */
+        if((_automaton.build(_bytecode) == false) && ((_engine == Engine::ENGINE_DFA) || (_engine == Engine::ENGINE_FULLDFA)) && (_loglevel >= LogLevel::LOG_ALERT)) {
+            _ostream << "🟠" << ' ' << "the" << ' ' << Engine::name(_engine) << ' ' << "engine cannot run this pattern, the backtracking executor is used instead" << std::endl;
+        }
+    }
+    return _automaton.valid();
+}
+
+auto RegExp::prepare_full() -> bool
+{
+    /* past its state limit, the full DFA is not built and the lazy DFA takes over */
+    if(_built == false) {
+        _built = true;
+        if(prepare_automaton() != false) {
+            _full.build(_bytecode, _automaton);
+        }
+    }
+    return _full.valid();
+}
+
+auto RegExp::count_reserved(const MatchScratch& scratch) -> void
+{
+    _stats.count_reserved(_bytecode.capacity() + scratch.bytes_reserved() + _dfa.bytes_reserved() + _full.bytes_reserved());
 }
 
 // ---------------------------------------------------------------------------
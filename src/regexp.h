@@ -21,6 +21,12 @@
 #include "bytecode.h"
 #include "compiler.h"
 #include "executor.h"
+#include "automaton.h"
+#include "scratch.h"
+#include "lazydfa.h"
+#include "fulldfa.h"
+#include "engine.h"
+#include "stats.h"
 
 // ---------------------------------------------------------------------------
 // RegExp
@@ -41,14 +47,107 @@ public: // public interface
 
     virtual ~RegExp() = default;
 
+    static constexpr size_t MIN_DFA_INPUT       = 256;   // below, the DFA setup costs more than the search
+    static constexpr size_t MAX_BACKTRACK_INPUT = 65536; // above, a repetition may backtrack over the whole input
+    static constexpr size_t MAX_DFA_NODES       = 16384; // above, the DFA states get too large
+    static constexpr size_t PREFILTER_SAMPLE    = 4096;  // bytes sampled to weigh the first characters of a match
+    static constexpr size_t PREFILTER_DENSITY   = 16;    // above one of them every so many bytes, the DFA wins
+
     auto compile(const std::string& string) -> bool;
 
+    auto compile(const char* data, const size_t size) -> bool;
+
+    auto compile(const char* data, const size_t size, const uint32_t flags) -> bool;
+
+    auto compile(const RegExp& regexp) -> bool;
+
     auto execute(const std::string& string) -> bool;
 
+    auto execute(const char* data, const size_t size) -> bool;
+
+    auto execute(const char* data, const size_t size, MatchScratch& scratch) -> bool;
+
+    auto is_match(const std::string& string) -> bool;
+
+    auto is_match(const char* data, const size_t size) -> bool;
+
+    auto is_match(const char* data, const size_t size, MatchScratch& scratch) -> bool;
+
+    auto scan_lines(const char* data, const size_t size, std::vector<Line>& lines) -> size_t;
+
+    auto scan_lines(const char* data, const size_t size, std::vector<Line>& lines, MatchScratch& scratch) -> size_t;
+
+    auto count(const char* data, const size_t size) -> size_t;
+
+    auto count(const char* data, const size_t size, MatchScratch& scratch) -> size_t;
+
+    auto execute_batch(const Input* inputs, const size_t count, uint64_t* results) -> size_t;
+
+    auto execute_batch(const Input* inputs, const size_t count, uint64_t* results, MatchScratch& scratch) -> size_t;
+
+    auto execute_chain(const Input* segments, const size_t count) -> bool;
+
+    auto execute_chain(const Input* segments, const size_t count, MatchScratch& scratch) -> bool;
+
+    auto save_dfa(std::vector<uint8_t>& image) -> bool;
+
+    auto load_dfa(const uint8_t* data, const size_t size) -> bool;
+
+    auto set_engine(const uint32_t engine) -> void
+    {
+        _engine = engine;
+    }
+
+    auto engine() const -> uint32_t
+    {
+        return _engine;
+    }
+
+    auto error() const -> const CompileError&
+    {
+        return _error;
+    }
+
+    auto stats() const -> const Stats&
+    {
+        return _stats;
+    }
+
+protected: // protected interface
+    auto select(const char* data, const size_t size, const bool contiguous) -> uint32_t;
+
+    auto selective(const char* data, const size_t size) -> bool;
+
+    auto scan(const char* data, const size_t size, std::vector<Line>* lines, MatchScratch& scratch) -> size_t;
+
+    auto match_literal(const char* data, const size_t size) -> bool;
+
+    auto match_literal_chain(const Input* segments, const size_t count, const size_t size, MatchScratch& scratch) -> bool;
+
+    auto prepare_automaton() -> bool;
+
+    auto prepare_full() -> bool;
+
+    auto count_reserved(const MatchScratch& scratch) -> void;
+
 protected: // protected data
-    OStream&       _ostream;
-    const uint32_t _loglevel;
-    ByteCode       _bytecode;
+    OStream&           _ostream;
+    const uint32_t     _loglevel;
+    ByteCode           _bytecode;
+    Compiler<TraceOff> _compiler; // kept so that its buffers are reused across compiles
+    CompileError       _error;
+    Stats              _stats;
+    Automaton          _automaton;
+    LazyDFA            _dfa;
+    FullDFA            _full;
+    MatchScratch       _scratch;
+    uint32_t           _engine;
+    uint32_t           _flags;
+    Literal            _literal;
+    ByteSet            _first;
+    bool               _prefiltered;
+    bool               _prepared;
+    bool               _built;
 };
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,242 @@
+/*
+ * scan.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "scan.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::count_trailing_zeros
+// ---------------------------------------------------------------------------
+
+namespace {
+
+inline auto count_trailing_zeros(const uint32_t value) -> size_t
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(value);
+#else
+    size_t count = 0;
+    while(((value >> count) & 1) == 0) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Scan
+// ---------------------------------------------------------------------------
+
+auto Scan::find_pair(const char* data, const size_t size, const uint8_t lower, const uint8_t upper) -> size_t
+{
+    size_t offset = 0;
+
+    if(lower == upper) {
+        const void* found = ::memchr(data, lower, size);
+        if(found != nullptr) {
+            return static_cast<const char*>(found) - data;
+        }
+        return size;
+    }
+#if defined(__SSE2__)
+    const __m128i lower_x16 = _mm_set1_epi8(static_cast<char>(lower));
+    const __m128i upper_x16 = _mm_set1_epi8(static_cast<char>(upper));
+    for(; (size - offset) >= 16; offset += 16) {
+        const __m128i  bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const __m128i  equal = _mm_or_si128(_mm_cmpeq_epi8(bytes, lower_x16), _mm_cmpeq_epi8(bytes, upper_x16));
+        const uint32_t mask  = static_cast<uint32_t>(_mm_movemask_epi8(equal));
+        if(mask != 0) {
+            return offset + count_trailing_zeros(mask);
+        }
+    }
+#endif
+    for(; offset < size; ++offset) {
+        const uint8_t byte = static_cast<uint8_t>(data[offset]);
+        if((byte == lower) || (byte == upper)) {
+            break;
+        }
+    }
+    return offset;
+}
+
+auto Scan::span_pair(const char* data, const size_t size, const uint8_t lower, const uint8_t upper) -> size_t
+{
+    size_t offset = 0;
+
+#if defined(__SSE2__)
+    const __m128i lower_x16 = _mm_set1_epi8(static_cast<char>(lower));
+    const __m128i upper_x16 = _mm_set1_epi8(static_cast<char>(upper));
+    for(; (size - offset) >= 16; offset += 16) {
+        const __m128i  bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const __m128i  equal = _mm_or_si128(_mm_cmpeq_epi8(bytes, lower_x16), _mm_cmpeq_epi8(bytes, upper_x16));
+        const uint32_t mask  = static_cast<uint32_t>(_mm_movemask_epi8(equal)) ^ 0xffff;
+        if(mask != 0) {
+            return offset + count_trailing_zeros(mask);
+        }
+    }
+#endif
+    for(; offset < size; ++offset) {
+        const uint8_t byte = static_cast<uint8_t>(data[offset]);
+        if((byte != lower) && (byte != upper)) {
+            break;
+        }
+    }
+    return offset;
+}
+
+auto Scan::span_ascii(const char* data, const size_t size) -> size_t
+{
+    size_t offset = 0;
+
+#if defined(__SSE2__)
+    for(; (size - offset) >= 16; offset += 16) {
+        const __m128i  bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const uint32_t mask  = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+        if(mask != 0) {
+            return offset + count_trailing_zeros(mask);
+        }
+    }
+#endif
+    for(; offset < size; ++offset) {
+        if((static_cast<uint8_t>(data[offset]) & 0x80) != 0) {
+            break;
+        }
+    }
+    return offset;
+}
+
+auto Scan::find_literal(const char* data, const size_t size, const char* literal, const size_t length) -> size_t
+{
+    size_t offset = 0;
+
+    auto two_way = [&]() -> size_t
+    {
+        const void* found = ::memmem(data + offset, size - offset, literal, length);
+        if(found != nullptr) {
+            return static_cast<const char*>(found) - data;
+        }
+        return size;
+    };
+
+    if(length > size) {
+        return size;
+    }
+    if(length <= 1) {
+        return (length == 0 ? 0 : find_pair(data, size, literal[0], literal[0]));
+    }
+#if defined(__SSE2__)
+    /*
+     * the candidates are the offsets where both the first and the last byte
+     * of the literal match, 16 at a time. When the false candidates cost more
+     * than twice the bytes scanned, the search switches to the Two-Way search
+     * of memmem(), which stays linear
+     */
+    const __m128i first_x16 = _mm_set1_epi8(literal[0]);
+    const __m128i last_x16  = _mm_set1_epi8(literal[length - 1]);
+    size_t        misses    = 0;
+    for(; (size - offset) >= (length + 15); offset += 16) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const __m128i last  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + length - 1));
+        uint32_t      mask  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, first_x16), _mm_cmpeq_epi8(last, last_x16))));
+        while(mask != 0) {
+            const size_t found = offset + count_trailing_zeros(mask);
+            if(::memcmp(data + found + 1, literal + 1, length - 2) == 0) {
+                return found;
+            }
+            if((++misses * length) > ((offset * 2) + 4096)) {
+                return two_way();
+            }
+            mask &= (mask - 1);
+        }
+    }
+#endif
+    return two_way();
+}
+
+auto Scan::line_begin(const char* data, const size_t size) -> size_t
+{
+    const void* found = ::memrchr(data, '\n', size);
+    if(found != nullptr) {
+        return (static_cast<const char*>(found) - data) + 1;
+    }
+    return 0;
+}
+
+auto Scan::line_end(const char* data, const size_t size) -> size_t
+{
+    const void* found = ::memchr(data, '\n', size);
+    if(found != nullptr) {
+        return static_cast<const char*>(found) - data;
+    }
+    return size;
+}
+
+auto Scan::utf8_length(const char* data, const size_t size) -> size_t
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+
+    auto in_range = [&](const size_t index, const uint8_t lower, const uint8_t upper) -> bool
+    {
+        return (index < size) && (bytes[index] >= lower) && (bytes[index] <= upper);
+    };
+
+    if(size == 0) {
+        return 0;
+    }
+    const uint8_t lead = bytes[0];
+    if(lead <= 0x7f) {
+        return 1;
+    }
+    if((lead >= 0xc2) && (lead <= 0xdf)) {
+        return (in_range(1, 0x80, 0xbf) ? 2 : 0);
+    }
+    if((lead >= 0xe0) && (lead <= 0xef)) {
+        const uint8_t lower = (lead == 0xe0 ? 0xa0 : 0x80);
+        const uint8_t upper = (lead == 0xed ? 0x9f : 0xbf);
+        return (in_range(1, lower, upper) && in_range(2, 0x80, 0xbf) ? 3 : 0);
+    }
+    if((lead >= 0xf0) && (lead <= 0xf4)) {
+        const uint8_t lower = (lead == 0xf0 ? 0x90 : 0x80);
+        const uint8_t upper = (lead == 0xf4 ? 0x8f : 0xbf);
+        return (in_range(1, lower, upper) && in_range(2, 0x80, 0xbf) && in_range(3, 0x80, 0xbf) ? 4 : 0);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,45 @@
+/*
+ * scan.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Scan_h__
+#define __Scan_h__
+
+// ---------------------------------------------------------------------------
+// Scan: vectorized byte scans used by the engines
+// ---------------------------------------------------------------------------
+
+struct Scan
+{
+    static auto find_pair(const char* data, const size_t size, const uint8_t lower, const uint8_t upper) -> size_t;
+
+    static auto span_pair(const char* data, const size_t size, const uint8_t lower, const uint8_t upper) -> size_t;
+
+    static auto span_ascii(const char* data, const size_t size) -> size_t;
+
+    static auto find_literal(const char* data, const size_t size, const char* literal, const size_t length) -> size_t;
+
+    static auto line_begin(const char* data, const size_t size) -> size_t;
+
+    static auto line_end(const char* data, const size_t size) -> size_t;
+
+    static auto utf8_length(const char* data, const size_t size) -> size_t;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Scan_h__ */
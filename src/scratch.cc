@@ -0,0 +1,90 @@
+/*
+ * scratch.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include "scratch.h"
+
+
+// ---------------------------------------------------------------------------
+// MatchScratch
+// ---------------------------------------------------------------------------
+
+MatchScratch::MatchScratch()
+    : marks()
+    , stack()
+    , nodes()
+    , spill()
+    , window()
+    , _generation(0)
+{
+}
+
+auto MatchScratch::reserve(const Automaton& automaton) -> void
+{
+    const size_t size = automaton.size();
+
+    if(marks.size() < size) {
+        marks.assign(size, 0);
+        _generation = 0;
+    }
+    stack.reserve((size * 2) + 1);
+    nodes.reserve(size + 1);
+}
+
+auto MatchScratch::release() -> void
+{
+    std::vector<uint32_t>().swap(marks);
+    std::vector<uint32_t>().swap(stack);
+    std::vector<uint32_t>().swap(nodes);
+    std::vector<uint32_t>().swap(spill);
+    std::vector<char>().swap(window);
+    _generation = 0;
+}
+
+auto MatchScratch::bytes_reserved() const -> size_t
+{
+    return ((marks.capacity() + stack.capacity() + nodes.capacity() + spill.capacity()) * sizeof(uint32_t)) + window.capacity();
+}
+
+auto MatchScratch::next_generation() -> uint32_t
+{
+    if(++_generation == 0) {
+        std::fill(marks.begin(), marks.end(), 0);
+        _generation = 1;
+    }
+    return _generation;
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
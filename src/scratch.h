@@ -0,0 +1,63 @@
+/*
+ * scratch.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Scratch_h__
+#define __Scratch_h__
+
+#include "automaton.h"
+
+// ---------------------------------------------------------------------------
+// MatchScratch: working memory of the engines, reused across executions
+// ---------------------------------------------------------------------------
+
+class MatchScratch
+{
+public: // public interface
+    MatchScratch();
+
+    MatchScratch(MatchScratch&&) = delete;
+
+    MatchScratch(const MatchScratch&) = delete;
+
+    MatchScratch& operator=(MatchScratch&&) = delete;
+
+    MatchScratch& operator=(const MatchScratch&) = delete;
+
+    virtual ~MatchScratch() = default;
+
+    auto reserve(const Automaton& automaton) -> void;
+
+    auto release() -> void;
+
+    auto bytes_reserved() const -> size_t;
+
+    auto next_generation() -> uint32_t;
+
+    std::vector<uint32_t> marks;  // visit marks of the automaton nodes, one per node
+    std::vector<uint32_t> stack;  // epsilon-closure work stack
+    std::vector<uint32_t> nodes;  // the state set being built
+    std::vector<uint32_t> spill;  // node sets saved aside while the DFA cache is flushed
+    std::vector<char>     window; // bytes around a segment boundary, searched for a literal
+
+protected: // protected data
+    uint32_t _generation;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Scratch_h__ */
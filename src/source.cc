@@ -0,0 +1,156 @@
+/*
+ * source.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source.h"
+
+// ---------------------------------------------------------------------------
+// Source
+// ---------------------------------------------------------------------------
+
+Source::Source()
+    : _data("")
+    , _size(0)
+    , _mapping(nullptr)
+    , _mapped(0)
+    , _buffer()
+{
+}
+
+Source::~Source()
+{
+    close();
+}
+
+auto Source::open(const std::string& path) -> void
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if(fd < 0) {
+        throw std::runtime_error(std::string("unable to open") + ' ' + '\'' + path + '\'' + ':' + ' ' + ::strerror(errno));
+    }
+    try {
+        load(fd, path);
+    }
+    catch(...) {
+        static_cast<void>(::close(fd));
+        throw;
+    }
+    static_cast<void>(::close(fd));
+}
+
+auto Source::load(const int fd, const std::string& name) -> void
+{
+    struct stat status;
+
+    close();
+    if(::fstat(fd, &status) != 0) {
+        throw std::runtime_error(std::string("unable to stat") + ' ' + '\'' + name + '\'' + ':' + ' ' + ::strerror(errno));
+    }
+    /* a regular file is mapped unless it is small, anything else (pipe, terminal, ...) is read */
+    if(S_ISREG(status.st_mode) && (static_cast<size_t>(status.st_size) >= MAP_THRESHOLD) && (map(fd, status.st_size) != false)) {
+        return;
+    }
+    read(fd, name, (S_ISREG(status.st_mode) ? status.st_size : 0));
+}
+
+auto Source::close() -> void
+{
+    if(_mapping != nullptr) {
+        static_cast<void>(::munmap(_mapping, _mapped));
+    }
+    _data    = "";
+    _size    = 0;
+    _mapping = nullptr;
+    _mapped  = 0;
+    _buffer.clear();
+}
+
+auto Source::map(const int fd, const size_t size) -> bool
+{
+    if(size == 0) {
+        return true;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapping == MAP_FAILED) {
+        return false;
+    }
+    /* the input is scanned once from start to end */
+    static_cast<void>(::madvise(mapping, size, MADV_SEQUENTIAL));
+    _data    = static_cast<const char*>(mapping);
+    _size    = size;
+    _mapping = mapping;
+    _mapped  = size;
+    return true;
+}
+
+auto Source::read(const int fd, const std::string& name, const size_t length) -> void
+{
+    size_t used = 0;
+
+    /* the length of a regular file is known, so it is read in one call without waiting for its end */
+    if(length != 0) {
+        _buffer.resize(length);
+    }
+    for(;;) {
+        if((length != 0) && (used >= length)) {
+            break;
+        }
+        if(_buffer.size() <= used) {
+            _buffer.resize(used + CHUNK_SIZE);
+        }
+        const ssize_t count = ::read(fd, _buffer.data() + used, _buffer.size() - used);
+        if(count < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("unable to read") + ' ' + '\'' + name + '\'' + ':' + ' ' + ::strerror(errno));
+        }
+        if(count == 0) {
+            break;
+        }
+        used += count;
+    }
+    _buffer.resize(used);
+    if(used != 0) {
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+/*
+ * source.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Source_h__
+#define __Source_h__
+
+// ---------------------------------------------------------------------------
+// Source: the whole content of a file, mapped when possible
+// ---------------------------------------------------------------------------
+
+class Source
+{
+public: // public interface
+    Source();
+
+    Source(Source&&) = delete;
+
+    Source(const Source&) = delete;
+
+    Source& operator=(Source&&) = delete;
+
+    Source& operator=(const Source&) = delete;
+
+    virtual ~Source();
+
+    static constexpr size_t CHUNK_SIZE    = 65536;
+    static constexpr size_t MAP_THRESHOLD = 65536; // below, a read costs less than a mapping
+
+    auto open(const std::string& path) -> void;
+
+    auto load(const int fd, const std::string& name) -> void;
+
+    auto close() -> void;
+
+    auto data() const -> const char*
+    {
+        return _data;
+    }
+
+    auto size() const -> size_t
+    {
+        return _size;
+    }
+
+protected: // protected interface
+    auto map(const int fd, const size_t size) -> bool;
+
+    auto read(const int fd, const std::string& name, const size_t length) -> void;
+
+protected: // protected data
+    const char*       _data;
+    size_t            _size;
+    void*             _mapping;
+    size_t            _mapped;
+    std::vector<char> _buffer;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Source_h__ */
@@ -0,0 +1,90 @@
+/*
+ * stats.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include "bytecode.h"
+#include "engine.h"
+#include "stats.h"
+
+// ---------------------------------------------------------------------------
+// Stats
+// ---------------------------------------------------------------------------
+
+auto Stats::reset() -> void
+{
+    for(auto& instruction : instructions) {
+        instruction = 0;
+    }
+    start_offsets  = 0;
+    backtracks     = 0;
+    peak_depth     = 0;
+    bytes_scanned  = 0;
+    dfa_states     = 0;
+    dfa_flushes    = 0;
+    bytes_reserved = 0;
+    engine         = 0;
+}
+
+auto Stats::print(OStream& ostream) const -> void
+{
+    auto print_value = [&](const std::string& name, const uint64_t value) -> void
+    {
+        ostream << "⚪" << ' ' << "stats:" << name << ' ' << '<' << value << '>' << std::endl;
+    };
+
+    if(enabled == false) {
+        ostream << "⚪" << ' ' << "stats are not available in this build" << std::endl;
+        return;
+    }
+    uint64_t total = 0;
+    for(auto& instruction : instructions) {
+        total += instruction;
+    }
+    print_value("instructions", total);
+    for(size_t opcode = 0; opcode < MAX_OPCODES; ++opcode) {
+        if(instructions[opcode] != 0) {
+            print_value(std::string("instructions:") + ByteCode::opcode_name(opcode), instructions[opcode]);
+        }
+    }
+    print_value("start_offsets" , start_offsets );
+    print_value("backtracks"    , backtracks    );
+    print_value("peak_depth"    , peak_depth    );
+    print_value("bytes_scanned" , bytes_scanned );
+    print_value("dfa_states"    , dfa_states    );
+    print_value("dfa_flushes"   , dfa_flushes   );
+    print_value("bytes_reserved", bytes_reserved);
+    ostream << "⚪" << ' ' << "stats:engine" << ' ' << '<' << Engine::name(engine) << '>' << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+/*
+ * stats.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Stats_h__
+#define __Stats_h__
+
+#include "loglevel.h"
+
+// ---------------------------------------------------------------------------
+// ENABLE_STATS
+// ---------------------------------------------------------------------------
+
+#ifndef ENABLE_STATS
+#define ENABLE_STATS 1
+#endif
+
+// ---------------------------------------------------------------------------
+// Stats
+// ---------------------------------------------------------------------------
+
+struct Stats
+{
+    static constexpr bool   enabled     = (ENABLE_STATS != 0);
+    static constexpr size_t MAX_OPCODES = 32;
+
+    uint64_t instructions[MAX_OPCODES];
+    uint64_t start_offsets;
+    uint64_t backtracks;
+    uint64_t peak_depth;
+    uint64_t bytes_scanned;
+    uint64_t dfa_states;
+    uint64_t dfa_flushes;
+    uint64_t bytes_reserved;
+    uint32_t engine;
+
+    Stats()
+    {
+        reset();
+    }
+
+    auto reset() -> void;
+
+    auto print(OStream& ostream) const -> void;
+
+    auto count_instruction(const uint8_t opcode) -> void
+    {
+        if(enabled && (opcode < MAX_OPCODES)) {
+            ++instructions[opcode];
+        }
+    }
+
+    auto count_start_offset() -> void
+    {
+        if(enabled) {
+            ++start_offsets;
+        }
+    }
+
+    auto count_backtrack() -> void
+    {
+        if(enabled) {
+            ++backtracks;
+        }
+    }
+
+    auto count_depth(const uint64_t depth) -> void
+    {
+        if(enabled && (depth > peak_depth)) {
+            peak_depth = depth;
+        }
+    }
+
+    auto count_bytes(const uint64_t count) -> void
+    {
+        if(enabled) {
+            bytes_scanned += count;
+        }
+    }
+
+    auto count_dfa_states(const uint64_t count) -> void
+    {
+        if(enabled) {
+            dfa_states = count;
+        }
+    }
+
+    auto count_dfa_flush() -> void
+    {
+        if(enabled) {
+            ++dfa_flushes;
+        }
+    }
+
+    auto count_reserved(const uint64_t bytes) -> void
+    {
+        if(enabled) {
+            bytes_reserved = bytes;
+        }
+    }
+
+    auto count_engine(const uint32_t selected) -> void
+    {
+        if(enabled) {
+            engine = selected;
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Stats_h__ */
@@ -0,0 +1,296 @@
+/*
+ * walker.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "walker.h"
+
+// ---------------------------------------------------------------------------
+// Walker::Worker
+// ---------------------------------------------------------------------------
+
+Walker::Worker::Worker()
+    : mutex()
+    , tasks()
+    , regexp(LogLevel::null_stream(), LogLevel::LOG_QUIET)
+    , source()
+    , lines()
+    , output()
+    , matches(0)
+{
+    output.reserve(BUFFER_SIZE + (BUFFER_SIZE / 4));
+}
+
+// ---------------------------------------------------------------------------
+// Walker
+// ---------------------------------------------------------------------------
+
+Walker::Walker(const RegExp& program, std::ostream& ostream, const uint32_t threads, const bool count)
+    : _program(program)
+    , _ostream(ostream)
+    , _threads(threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u))
+    , _count(count)
+    , _workers()
+    , _pending(0)
+    , _mutex()
+{
+}
+
+auto Walker::run(const std::string& root) -> uint64_t
+{
+    std::vector<std::thread> threads;
+    struct stat              status;
+    uint64_t                 matches = 0;
+
+    if(::stat(root.c_str(), &status) != 0) {
+        throw std::runtime_error(std::string("unable to stat") + ' ' + '\'' + root + '\'' + ':' + ' ' + ::strerror(errno));
+    }
+    /* every worker runs the same compiled program, the engines keep their caches per thread */
+    _workers.clear();
+    for(uint32_t index = 0; index < _threads; ++index) {
+        _workers.emplace_back(new Worker());
+        _workers.back()->regexp.compile(_program);
+    }
+    push(*_workers.front(), root, S_ISDIR(status.st_mode));
+    for(uint32_t index = 1; index < _threads; ++index) {
+        threads.emplace_back(&Walker::work, this, index);
+    }
+    work(0);
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(auto& worker : _workers) {
+        matches += worker->matches;
+    }
+    _workers.clear();
+
+    return matches;
+}
+
+auto Walker::push(Worker& worker, const std::string& path, const bool directory) -> void
+{
+    _pending.fetch_add(1);
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(Task { path, directory });
+}
+
+auto Walker::pop(Worker& worker, Task& task) -> bool
+{
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    if(worker.tasks.empty() == false) {
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+auto Walker::steal(const size_t thief, Task& task) -> bool
+{
+    /* the oldest task of a victim is taken, usually a directory high in its subtree */
+    for(size_t offset = 1; offset < _workers.size(); ++offset) {
+        Worker&                     victim(*_workers[(thief + offset) % _workers.size()]);
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(victim.tasks.empty() == false) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+auto Walker::work(const size_t index) -> void
+{
+    Worker&  worker(*_workers[index]);
+    Task     task;
+    uint32_t idle = 0;
+
+    /* a task is pending until it has been visited, so the count drops to zero only once the whole tree is done */
+    while(_pending.load() != 0) {
+        if((pop(worker, task) != false) || (steal(index, task) != false)) {
+            if(task.directory != false) {
+                visit_directory(worker, task.path);
+            }
+            else {
+                visit_file(worker, task.path);
+            }
+            _pending.fetch_sub(1);
+            idle = 0;
+        }
+        else if(++idle < IDLE_SPINS) {
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    flush(worker);
+}
+
+auto Walker::visit_directory(Worker& worker, const std::string& path) -> void
+{
+    DIR* directory = ::opendir(path.c_str());
+
+    if(directory == nullptr) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::cerr << "unable to open" << ' ' << '\'' << path << '\'' << ':' << ' ' << ::strerror(errno) << std::endl;
+        return;
+    }
+    const std::string prefix(path.empty() || (path.back() == '/') ? path : path + '/');
+    while(const struct dirent* entry = ::readdir(directory)) {
+        const char* name = entry->d_name;
+        if((name[0] == '.') && ((name[1] == '\0') || ((name[1] == '.') && (name[2] == '\0')))) {
+            continue;
+        }
+        unsigned char type = entry->d_type;
+        if(type == DT_UNKNOWN) {
+            struct stat status;
+            if(::fstatat(::dirfd(directory), name, &status, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            type = (S_ISDIR(status.st_mode) ? DT_DIR : S_ISREG(status.st_mode) ? DT_REG : DT_UNKNOWN);
+        }
+        /* the symbolic links, devices, pipes and sockets of the tree are not followed */
+        if(type == DT_DIR) {
+            push(worker, prefix + name, true);
+        }
+        else if(type == DT_REG) {
+            push(worker, prefix + name, false);
+        }
+    }
+    static_cast<void>(::closedir(directory));
+}
+
+auto Walker::visit_file(Worker& worker, const std::string& path) -> void
+{
+    uint64_t count = 0;
+
+    try {
+        worker.source.open(path);
+        /* a compressed file is opened again and decompressed chunk by chunk */
+        if(Reader::detect(worker.source.data(), worker.source.size()) != Reader::FORMAT_PLAIN) {
+            worker.source.close();
+            count = visit_compressed(worker, path);
+        }
+        else {
+            count = match(worker, path, worker.source.data(), worker.source.size(), 0);
+            worker.source.close();
+        }
+    }
+    catch(const std::exception& e) {
+        worker.source.close();
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::cerr << e.what() << std::endl;
+        return;
+    }
+    if((_count != false) && (count != 0)) {
+        worker.output.append(path);
+        worker.output.push_back(':');
+        worker.output.append(std::to_string(count));
+        worker.output.push_back('\n');
+    }
+    worker.matches += count;
+    /* the output is written in whole files, so that the lines of two files never interleave */
+    if(worker.output.size() >= BUFFER_SIZE) {
+        flush(worker);
+    }
+}
+
+auto Walker::visit_compressed(Worker& worker, const std::string& path) -> uint64_t
+{
+    const int   fd     = ::open(path.c_str(), O_RDONLY);
+    const char* data   = nullptr;
+    size_t      size   = 0;
+    uint64_t    offset = 0;
+    uint64_t    count  = 0;
+
+    if(fd < 0) {
+        throw std::runtime_error(std::string("unable to open") + ' ' + '\'' + path + '\'' + ':' + ' ' + ::strerror(errno));
+    }
+    try {
+        worker.reader.start(fd, path, Reader::IO_THREAD);
+        while(worker.reader.next(data, size) != false) {
+            count  += match(worker, path, data, size, offset);
+            offset += size;
+        }
+        worker.reader.close();
+    }
+    catch(...) {
+        worker.reader.close();
+        static_cast<void>(::close(fd));
+        throw;
+    }
+    static_cast<void>(::close(fd));
+
+    return count;
+}
+
+auto Walker::match(Worker& worker, const std::string& path, const char* data, const size_t size, const uint64_t offset) -> uint64_t
+{
+    if(_count != false) {
+        return worker.regexp.count(data, size);
+    }
+    worker.lines.clear();
+    worker.regexp.scan_lines(data, size, worker.lines);
+    for(auto& line : worker.lines) {
+        worker.output.append(path);
+        worker.output.push_back(':');
+        worker.output.append(std::to_string(offset + line.offset));
+        worker.output.push_back(':');
+        worker.output.append(data + line.offset, line.size);
+        worker.output.push_back('\n');
+    }
+    return worker.lines.size();
+}
+
+auto Walker::flush(Worker& worker) -> void
+{
+    if(worker.output.empty() == false) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ostream.write(worker.output.data(), worker.output.size());
+        worker.output.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
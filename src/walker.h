@@ -0,0 +1,109 @@
+/*
+ * walker.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Walker_h__
+#define __Walker_h__
+
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include "regexp.h"
+#include "source.h"
+#include "reader.h"
+
+// ---------------------------------------------------------------------------
+// Walker: match the files of a directory tree on a pool of threads
+// ---------------------------------------------------------------------------
+
+class Walker
+{
+public: // public interface
+    Walker(const RegExp& program, std::ostream& ostream, const uint32_t threads, const bool count);
+
+    Walker(Walker&&) = delete;
+
+    Walker(const Walker&) = delete;
+
+    Walker& operator=(Walker&&) = delete;
+
+    Walker& operator=(const Walker&) = delete;
+
+    virtual ~Walker() = default;
+
+    static constexpr size_t   BUFFER_SIZE = 65536; // output kept by a worker before it is written
+    static constexpr uint32_t IDLE_SPINS  = 64;    // failed steals before an idle worker sleeps
+
+    auto run(const std::string& root) -> uint64_t;
+
+    auto threads() const -> uint32_t
+    {
+        return _threads;
+    }
+
+protected: // protected interface
+    struct Task
+    {
+        std::string path;
+        bool        directory;
+    };
+
+    struct Worker
+    {
+        Worker();
+
+        std::mutex        mutex;  // guards the tasks, the owner works at the back, thieves at the front
+        std::deque<Task>  tasks;
+        RegExp            regexp; // the shared program with the engine state of this thread
+        Source            source;
+        Reader            reader; // decompresses a compressed file on its own thread
+        std::vector<Line> lines;
+        std::string       output;
+        uint64_t          matches;
+    };
+
+    auto push(Worker& worker, const std::string& path, const bool directory) -> void;
+
+    auto pop(Worker& worker, Task& task) -> bool;
+
+    auto steal(const size_t thief, Task& task) -> bool;
+
+    auto work(const size_t index) -> void;
+
+    auto visit_directory(Worker& worker, const std::string& path) -> void;
+
+    auto visit_file(Worker& worker, const std::string& path) -> void;
+
+    auto visit_compressed(Worker& worker, const std::string& path) -> uint64_t;
+
+    auto match(Worker& worker, const std::string& path, const char* data, const size_t size, const uint64_t offset) -> uint64_t;
+
+    auto flush(Worker& worker) -> void;
+
+protected: // protected data
+    const RegExp&                        _program;
+    std::ostream&                        _ostream;
+    const uint32_t                       _threads;
+    const bool                           _count;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<uint64_t>                _pending;
+    std::mutex                           _mutex;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Walker_h__ */